@@ -0,0 +1,270 @@
+/*
+ * DS3232Decode.cpp - decode DS3232 time and alarm register blocks, one or many at a time
+ * Needs neither Wire nor Time.h, so the same code runs on the host to ingest dumps.
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "DS3232Decode.h"
+
+// Host builds decode several blocks per step, one per 32 bit lane
+#if defined(__AVX2__) && !defined(DS3232_NO_SIMD)
+#include <immintrin.h>
+#define DS3232_LANES 8
+#elif defined(__SSE2__) && !defined(DS3232_NO_SIMD)
+#include <emmintrin.h>
+#define DS3232_LANES 4
+#endif
+
+#define LEAPS_TO_1970       477  // leap years 1~1969
+#define DAYS_PER_YEAR       365UL
+
+// Days before each month in a common year, indexed by the month register
+// (1~12); 0 and the BCD values past 12 are not valid months but stay in range
+static const uint16_t daysBefore[32] PROGMEM = {
+    0,   0,  31,  59,  90, 120, 151, 181, 212, 243, 273, 304, 334, 365, 365, 365,
+  365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365, 365
+};
+
+/**
+ * \brief One time block to seconds since 1970, the same as makeTime() of DS3232RTC::read()
+ * The loop body of ds3232DecodeTimes(), kept free of data dependent branches.
+ */
+static inline uint32_t decodeTime(const uint8_t *b) {
+  uint8_t ty = ds3232Year(b[5], b[6]) + 30;  // years since 1970, as tmElements_t holds it
+  uint16_t year = 1970 + ty;
+  uint16_t prev = year - 1;
+  uint8_t month = ds3232Bcd2Dec(b[5] & 0x1F);
+  uint32_t leap = ((year & 3) == 0) & (((year % 100) != 0) | ((year % 400) == 0));
+  uint32_t days = DAYS_PER_YEAR * ty +
+    (prev / 4 - prev / 100 + prev / 400) - LEAPS_TO_1970 +
+    pgm_read_word(&daysBefore[month]) + (leap & (month > 2)) +
+    ds3232Bcd2Dec(b[4] & 0x3F) - 1;
+  return days * 86400UL +
+    ds3232Hour(b[2] & 0x7F) * 3600UL +
+    ds3232Bcd2Dec(b[1] & 0x7F) * 60UL +
+    ds3232Bcd2Dec(b[0] & 0x7F);
+}
+
+#ifdef DS3232_LANES
+#if DS3232_LANES == 8
+typedef __m256i lanes_t;
+#define L_SET(x)          _mm256_set1_epi32(x)
+#define L_ADD(a, b)       _mm256_add_epi32(a, b)
+#define L_SUB(a, b)       _mm256_sub_epi32(a, b)
+#define L_MUL(a, b)       _mm256_mullo_epi32(a, b)
+#define L_AND(a, b)       _mm256_and_si256(a, b)
+#define L_OR(a, b)        _mm256_or_si256(a, b)
+#define L_ANDNOT(a, b)    _mm256_andnot_si256(a, b)  // ~a & b
+#define L_SHL(a, n)       _mm256_slli_epi32(a, n)
+#define L_SHR(a, n)       _mm256_srli_epi32(a, n)
+#define L_EQ(a, b)        _mm256_cmpeq_epi32(a, b)
+#define L_GT(a, b)        _mm256_cmpgt_epi32(a, b)
+
+/**
+ * \brief Bytes offset~offset+3 of 8 consecutive blocks, one block per lane
+ */
+static inline lanes_t loadLanes(const uint8_t *blocks, int offset) {
+  const __m256i at = _mm256_setr_epi32(0, 7, 14, 21, 28, 35, 42, 49);
+  return _mm256_i32gather_epi32((const int *)(blocks + offset), at, 1);
+}
+
+static inline void storeLanes(uint32_t *out, lanes_t v) {
+  _mm256_storeu_si256((__m256i *)out, v);
+}
+#else
+typedef __m128i lanes_t;
+#define L_SET(x)          _mm_set1_epi32(x)
+#define L_ADD(a, b)       _mm_add_epi32(a, b)
+#define L_SUB(a, b)       _mm_sub_epi32(a, b)
+#define L_MUL(a, b)       mulLanes(a, b)
+#define L_AND(a, b)       _mm_and_si128(a, b)
+#define L_OR(a, b)        _mm_or_si128(a, b)
+#define L_ANDNOT(a, b)    _mm_andnot_si128(a, b)  // ~a & b
+#define L_SHL(a, n)       _mm_slli_epi32(a, n)
+#define L_SHR(a, n)       _mm_srli_epi32(a, n)
+#define L_EQ(a, b)        _mm_cmpeq_epi32(a, b)
+#define L_GT(a, b)        _mm_cmpgt_epi32(a, b)
+
+/**
+ * \brief Low 32 bits of a * b per lane, SSE2 only multiplies lanes 0 and 2
+ */
+static inline lanes_t mulLanes(lanes_t a, lanes_t b) {
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+    _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/**
+ * \brief Bytes offset~offset+3 of 4 consecutive blocks, one block per lane
+ */
+static inline lanes_t loadLanes(const uint8_t *blocks, int offset) {
+  uint32_t v[4];
+  for (int i = 0; i < 4; i++) memcpy(&v[i], blocks + i * DS3232_TIME_BLOCK + offset, 4);
+  return _mm_loadu_si128((const __m128i *)v);
+}
+
+static inline void storeLanes(uint32_t *out, lanes_t v) {
+  _mm_storeu_si128((__m128i *)out, v);
+}
+#endif
+
+// BCD byte in each lane to decimal, num - 6 * (num >> 4)
+static inline lanes_t bcdLanes(lanes_t num) {
+  lanes_t tens = L_SHR(num, 4);
+  return L_SUB(num, L_ADD(L_SHL(tens, 2), L_SHL(tens, 1)));
+}
+
+// Lanes where mask is set take a, the others b
+static inline lanes_t pickLanes(lanes_t mask, lanes_t a, lanes_t b) {
+  return L_OR(L_AND(mask, a), L_ANDNOT(mask, b));
+}
+
+/**
+ * \brief decodeTime() of DS3232_LANES blocks at once
+ * Bytes 0~3 and 3~6 of each block are loaded as two words, so nothing
+ * past the last block is read.  The division by 100 is a multiply and
+ * shift, exact for the years 1969~2225 a block can hold, and daysBefore[]
+ * is worked out in place of the table.
+ */
+static inline void decodeLanes(const uint8_t *blocks, uint32_t *out) {
+  const lanes_t ff = L_SET(0xFF), one = L_SET(1), two = L_SET(2), twelve = L_SET(12);
+  lanes_t lo = loadLanes(blocks, 0);  // 00h~03h
+  lanes_t hi = loadLanes(blocks, 3);  // 03h~06h
+  lanes_t sec = bcdLanes(L_AND(lo, L_SET(0x7F)));
+  lanes_t min = bcdLanes(L_AND(L_SHR(lo, 8), L_SET(0x7F)));
+  lanes_t hr = L_AND(L_SHR(lo, 16), L_SET(0x7F));
+  lanes_t date = bcdLanes(L_AND(L_SHR(hi, 8), L_SET(0x3F)));
+  lanes_t mreg = L_AND(L_SHR(hi, 16), ff);
+  lanes_t yreg = L_SHR(hi, 24);
+
+  // ds3232Hour(), 12 hour format when bit 6 is set
+  lanes_t pm = L_AND(L_SHR(hr, 5), one);
+  lanes_t h12 = L_ADD(bcdLanes(L_AND(hr, L_SET(0x1F))), L_MUL(pm, twelve));
+  lanes_t hour = pickLanes(L_EQ(L_AND(hr, L_SET(0x40)), L_SET(0x40)), h12, bcdLanes(L_AND(hr, L_SET(0x3F))));
+
+  // Years since 1970, wrapped to 8 bits as ds3232Year() + 30 is
+  lanes_t ty = L_AND(L_ADD(L_ADD(bcdLanes(yreg), L_MUL(L_SHR(mreg, 7), L_SET(100))), L_SET(30)), ff);
+  lanes_t year = L_ADD(ty, L_SET(1970));
+  lanes_t prev = L_SUB(year, one);
+  lanes_t prevC = L_SHR(L_MUL(prev, L_SET(5243)), 19);  // prev / 100
+  lanes_t yearC = L_SHR(L_MUL(year, L_SET(5243)), 19);
+  lanes_t leaps = L_ADD(L_SUB(L_SHR(prev, 2), prevC), L_SHR(prevC, 2));
+  lanes_t century = L_EQ(year, L_MUL(yearC, L_SET(100)));
+  lanes_t leap = L_AND(L_EQ(L_AND(year, L_SET(3)), L_SET(0)),
+    L_OR(L_ANDNOT(century, one), L_AND(century, L_AND(L_EQ(L_AND(yearC, L_SET(3)), L_SET(0)), one))));
+
+  // daysBefore[] of months 1~12: 30 (m - 1) + (m + (m > 8)) / 2 - 2 (m > 2)
+  lanes_t month = bcdLanes(L_AND(mreg, L_SET(0x1F)));
+  lanes_t m1 = L_SUB(month, one);
+  lanes_t after2 = L_GT(month, two);
+  lanes_t before = L_SUB(L_ADD(L_SUB(L_SHL(m1, 5), L_SHL(m1, 1)),
+      L_SHR(L_SUB(month, L_GT(month, L_SET(8))), 1)),  // a true compare is -1
+    L_AND(after2, two));
+  before = pickLanes(L_GT(month, twelve), L_SET(365), before);
+  before = pickLanes(L_EQ(month, L_SET(0)), L_SET(0), before);
+
+  lanes_t days = L_ADD(L_ADD(L_MUL(ty, L_SET(365)), L_SUB(leaps, L_SET(LEAPS_TO_1970))),
+    L_ADD(L_ADD(before, L_AND(leap, after2)), L_SUB(date, one)));
+  lanes_t t = L_ADD(L_MUL(days, L_SET(86400)),
+    L_ADD(L_ADD(L_MUL(hour, L_SET(3600)), L_MUL(min, L_SET(60))), sec));
+  storeLanes(out, t);
+}
+#endif
+
+/**
+ * \brief Decode registers 00h~06h to seconds since 1970
+ */
+uint32_t ds3232DecodeTime(const uint8_t *block) {
+  return decodeTime(block);
+}
+
+/**
+ * \brief Decode count time blocks (DS3232_TIME_BLOCK bytes each) into out
+ * With SSE2 or AVX2 (host builds) DS3232_LANES blocks are decoded per
+ * step and the scalar loop takes the rest; the results are the same.
+ */
+void ds3232DecodeTimes(const uint8_t *blocks, size_t count, uint32_t *out) {
+  size_t i = 0;
+#ifdef DS3232_LANES
+  for (; i + DS3232_LANES <= count; i += DS3232_LANES) {
+    decodeLanes(blocks + i * DS3232_TIME_BLOCK, out + i);
+  }
+#endif
+  for (; i < count; i++) {
+    out[i] = decodeTime(blocks + i * DS3232_TIME_BLOCK);
+  }
+}
+
+/**
+ * \brief Decode one alarm; data is seconds, minutes, hours, day/date (seconds 0 for alarm 2)
+ */
+void ds3232DecodeAlarm(uint8_t alarm, const uint8_t *data, alarmElements_t &a) {
+  uint8_t flags;
+
+  flags = ((data[0] & 0x80) >> 7) | ((data[1] & 0x80) >> 6) |
+    ((data[2] & 0x80) >> 5) | ((data[3] & 0x80) >> 4);
+  if (flags == 0) flags = ((data[3] & 0x40) >> 2);
+  switch (flags) {
+    case 0x04: a.Mode = alarmModePerSecond; break;  // X1111
+    case 0x0E: a.Mode = (alarm == 1) ? alarmModeSecondsMatch : alarmModePerMinute; break;  // X1110
+    case 0x0A: a.Mode = alarmModeMinutesMatch; break;  // X1100
+    case 0x08: a.Mode = alarmModeHoursMatch; break;  // X1000
+    case 0x00: a.Mode = alarmModeDateMatch; break;  // 00000
+    case 0x10: a.Mode = alarmModeDayMatch; break;  // 10000
+    default: a.Mode = alarmModeUnknown; break;
+  }
+
+  a.Second = (alarm == 1) ? ds3232Bcd2Dec(data[0] & 0x7F) : 0;
+  a.Minute = ds3232Bcd2Dec(data[1] & 0x7F);
+  a.Hour = ds3232Hour(data[2]);
+  if ((data[3] & 0x40) == 0) {
+    // Alarm holds Date (of Month)
+    a.Day = ds3232Bcd2Dec(data[3] & 0x3F);
+    a.Wday = 0;
+  } else {
+    // Alarm holds Day (of Week)
+    a.Day = 0;
+    a.Wday = ds3232Bcd2Dec(data[3] & 0x07);
+  }
+
+  // TODO : Not too sure about this.
+  /*
+    If the alarm is set to trigger every Nth of the month
+    (or every 1-7 week day), but the date/day are 0 then
+    what?  The spec is not clear about alarm off conditions.
+    My assumption is that it would not trigger is date/day
+    set to 0, so I've created a Alarm-Off mode.
+  */
+  if ((a.Mode == alarmModeDateMatch) && (a.Day == 0)) {
+    a.Mode = alarmModeOff;
+  } else if ((a.Mode == alarmModeDayMatch) && (a.Wday == 0)) {
+    a.Mode = alarmModeOff;
+  }
+}
+
+/**
+ * \brief Decode count alarm blocks (DS3232_ALARM_BLOCK bytes each) into 2 * count alarms
+ * Scalar on every build: the mode is a lookup of the A1Mx/A2Mx flag pattern
+ * and the day/date and alarm-off cases branch per alarm, there are two
+ * alarms to a block against one time, and a dump holds few alarm blocks.
+ */
+void ds3232DecodeAlarms(const uint8_t *blocks, size_t count, alarmElements_t *out) {
+  uint8_t data[4];
+  size_t i;
+
+  data[0] = 0;  // alarm 2 doesn't use seconds
+  for (i = 0; i < count; i++) {
+    const uint8_t *b = blocks + i * DS3232_ALARM_BLOCK;
+    ds3232DecodeAlarm(1, b, out[2 * i]);
+    data[1] = b[4];
+    data[2] = b[5];
+    data[3] = b[6];
+    ds3232DecodeAlarm(2, data, out[2 * i + 1]);
+  }
+}
@@ -0,0 +1,58 @@
+/*
+ * DS3232Decode.h - decode DS3232 time and alarm register blocks, one or many at a time
+ * Needs neither Wire nor Time.h, so the same code runs on the host to ingest dumps.
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#ifndef DS3232Decode_h
+#define DS3232Decode_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "DS3232Regs.h"
+
+#define DS3232_TIME_BLOCK   7   // registers 00h~06h
+#define DS3232_ALARM_BLOCK  7   // registers 07h~0Dh, alarm 1 then alarm 2
+
+typedef struct {
+  alarmMode_t Mode;
+  uint8_t Second;
+  uint8_t Minute;
+  uint8_t Hour;
+  uint8_t Wday;   // day of week, when Mode is alarmModeDayMatch
+  uint8_t Day;    // date of month, otherwise
+} alarmElements_t;
+
+/**
+ * \brief Convert Binary Coded Decimal (BCD) to Decimal
+ */
+static inline uint8_t ds3232Bcd2Dec(uint8_t num) {
+  return num - 6 * (num >> 4);
+}
+
+/**
+ * \brief Hours register (02h, 09h, 0Ch) to 0~23
+ * 12 hour format with bit 5 set as PM, as DS3232RTC has always read it
+ */
+static inline uint8_t ds3232Hour(uint8_t b) {
+  if ((b & 0x40) != 0) return ds3232Bcd2Dec(b & 0x1F) + (((b & 0x20) != 0) ? 12 : 0);
+  return ds3232Bcd2Dec(b & 0x3F);
+}
+
+/**
+ * \brief Month (05h) and year (06h) registers to years since 2000 (0~199)
+ */
+static inline uint8_t ds3232Year(uint8_t month, uint8_t year) {
+  return ds3232Bcd2Dec(year) + (((month & 0x80) != 0) ? 100 : 0);
+}
+
+// Single block
+uint32_t ds3232DecodeTime(const uint8_t *block);
+void ds3232DecodeAlarm(uint8_t alarm, const uint8_t *data, alarmElements_t &a);
+// Arrays of blocks, packed back to back; times are seconds since 1970 as time_t on the device.
+// Only the times take the SIMD path, the alarms decode one block at a time.
+void ds3232DecodeTimes(const uint8_t *blocks, size_t count, uint32_t *out);
+void ds3232DecodeAlarms(const uint8_t *blocks, size_t count, alarmElements_t *out);
+
+#endif
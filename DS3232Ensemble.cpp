@@ -0,0 +1,162 @@
+/*
+ * DS3232Ensemble.cpp - one trusted time from several DS3232 chips
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#include <stdint.h>
+#include "DS3232Ensemble.h"
+#include "DS3232Regs.h"
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3232Ensemble Class                                                 | */
+/* +----------------------------------------------------------------------+ */
+
+/**
+ * \brief Flag chips more than threshold seconds from the ensemble time
+ * With autoResync, read() calls resync() as soon as it has the time.
+ */
+DS3232Ensemble::DS3232Ensemble(uint8_t threshold, bool autoResync)
+  : _count(0)
+  , _threshold(threshold)
+  , _auto(autoResync)
+  , _median(0)
+  , _readAt(0)
+{
+}
+
+/**
+ * \brief Add a chip and start its bus, returns false when DS3232ENSEMBLE_MAX are already in use
+ */
+bool DS3232Ensemble::add(DS3232Bus &bus) {
+  if (_count >= DS3232ENSEMBLE_MAX) return false;
+  bus.begin();
+  _bus[_count] = &bus;
+  _time[_count] = 0;
+  _status[_count] = DS3232ENSEMBLE_NOREPLY;
+  _stat[_count] = 0;
+  _count++;
+  return true;
+}
+
+/**
+ *
+ */
+uint8_t DS3232Ensemble::count() {
+  return _count;
+}
+
+/**
+ * \brief Read every chip and return the median time of the trusted ones
+ * One burst read of registers 00h~0Fh per chip, back to back, which also
+ * brings in the OSF bit.  Returns 0 if no chip can be trusted, or if no
+ * more than half of the trusted chips are within the threshold of the
+ * median, e.g. two chips that disagree.  The chips away from the median
+ * are flagged DRIFT either way, but without a majority there is no time
+ * for resync() to give them.
+ */
+time_t DS3232Ensemble::read() {
+  uint8_t data[DS3232ENSEMBLE_MAX][16];
+  uint8_t got[DS3232ENSEMBLE_MAX];
+  time_t sorted[DS3232ENSEMBLE_MAX];
+  tmElements_t tm;
+  uint8_t i, j, n = 0;
+
+  // Transfers first, so the chips are sampled as close together as possible
+  for (i = 0; i < _count; i++) {
+    got[i] = _bus[i]->read(0x00, data[i], 16);  // 00h - seconds register
+  }
+  _readAt = millis();
+
+  for (i = 0; i < _count; i++) {
+    if (got[i] != 16) {
+      _status[i] = DS3232ENSEMBLE_NOREPLY;
+      continue;
+    }
+    DS3232RTC::decodeTime(data[i], tm);
+    _time[i] = makeTime(tm);
+    _stat[i] = data[i][0x0F];  // 0Fh - Ctrl/Status register
+    _status[i] = ((_stat[i] & DS3232_OSF) != 0) ? DS3232ENSEMBLE_OSF : DS3232ENSEMBLE_OK;
+    if (_status[i] == DS3232ENSEMBLE_OK) {
+      // insertion sort, there are only a few
+      for (j = n; (j > 0) && (sorted[j - 1] > _time[i]); j--) sorted[j] = sorted[j - 1];
+      sorted[j] = _time[i];
+      n++;
+    }
+  }
+
+  if (n == 0) {
+    _median = 0;
+    return 0;
+  }
+  _median = sorted[(n - 1) / 2];
+  if ((n % 2) == 0) _median += (sorted[n / 2] - sorted[(n - 1) / 2]) / 2;
+
+  for (i = 0, j = 0; i < _count; i++) {
+    if (_status[i] != DS3232ENSEMBLE_OK) continue;
+    if ((_time[i] > _median + _threshold) || (_time[i] + _threshold < _median)) {
+      _status[i] |= DS3232ENSEMBLE_DRIFT;
+    } else {
+      j++;
+    }
+  }
+  if (2 * j <= n) _median = 0;  // no majority
+  if (_auto) resync();
+  return _median;
+}
+
+/**
+ * \brief Ensemble time from the last read()
+ */
+time_t DS3232Ensemble::get() {
+  return _median;
+}
+
+/**
+ * \brief DS3232ENSEMBLE_* flags of a chip from the last read()
+ */
+uint8_t DS3232Ensemble::status(uint8_t chip) {
+  if (chip >= _count) return DS3232ENSEMBLE_NOREPLY;
+  return _status[chip];
+}
+
+/**
+ * \brief Time a chip reported in the last read()
+ */
+time_t DS3232Ensemble::time(uint8_t chip) {
+  if (chip >= _count) return 0;
+  return _time[chip];
+}
+
+/**
+ * \brief Set the ensemble time on chips flagged OSF or DRIFT, returns how many
+ * The time is that of the last read() moved on by the whole seconds since.
+ * Also clears their OSF, leaving the alarm flags as they were.  Does
+ * nothing when the last read() found no majority.
+ */
+uint8_t DS3232Ensemble::resync() {
+  uint8_t data[7];
+  uint8_t stat;
+  uint8_t i, n = 0;
+  tmElements_t tm;
+  time_t now;
+
+  if (_median == 0) return 0;
+  now = _median + (millis() - _readAt) / 1000;
+  breakTime(now, tm);
+  DS3232RTC::encodeTime(tm, data);
+  for (i = 0; i < _count; i++) {
+    if ((_status[i] & (DS3232ENSEMBLE_OSF | DS3232ENSEMBLE_DRIFT)) == 0) continue;
+    if ((_status[i] & DS3232ENSEMBLE_NOREPLY) != 0) continue;
+    _bus[i]->write(0x00, data, 7);  // sends 00h - seconds register
+    // A1F/A2F ignore writes of 1, so they are kept as is
+    stat = (_stat[i] & ~DS3232_OSF) | DS3232_A1F | DS3232_A2F;
+    _bus[i]->write(0x0F, &stat, 1);  // sends 0Fh - Ctrl/Status register
+    _stat[i] &= ~DS3232_OSF;
+    _time[i] = now;
+    _status[i] = DS3232ENSEMBLE_OK;
+    n++;
+  }
+  return n;
+}
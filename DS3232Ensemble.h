@@ -0,0 +1,52 @@
+/*
+ * DS3232Ensemble.h - one trusted time from several DS3232 chips
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#ifndef DS3232Ensemble_h
+#define DS3232Ensemble_h
+
+#include <stdint.h>
+#include <TimeLib.h> // http://playground.arduino.cc/Code/time
+#include "DS3232RTC.h"
+
+#define DS3232ENSEMBLE_MAX      4
+
+// Per chip status after read()
+#define DS3232ENSEMBLE_OK       0x00
+#define DS3232ENSEMBLE_OSF      0x01  // oscillator stopped, time not trusted
+#define DS3232ENSEMBLE_DRIFT    0x02  // further than the threshold from the ensemble
+#define DS3232ENSEMBLE_NOREPLY  0x04  // no answer on its bus
+
+/**
+ * DS3232Ensemble Class
+ * Each chip is a DS3232Bus, e.g. DS3232Wire on its own TwoWire or behind a mux.
+ * add() starts the bus.  read() flags outliers; with autoResync it also
+ * sets them to the time it just sampled, otherwise call resync().
+ */
+class DS3232Ensemble
+{
+  public:
+    DS3232Ensemble(uint8_t threshold = 2, bool autoResync = false);
+    bool add(DS3232Bus &bus);
+    uint8_t count();
+    time_t read();
+    time_t get();
+    uint8_t status(uint8_t chip);
+    time_t time(uint8_t chip);
+    uint8_t resync();
+  private:
+    DS3232Bus *_bus[DS3232ENSEMBLE_MAX];
+    time_t _time[DS3232ENSEMBLE_MAX];
+    uint8_t _status[DS3232ENSEMBLE_MAX];
+    uint8_t _stat[DS3232ENSEMBLE_MAX];  // copy of the Status register
+    uint8_t _count;
+    uint8_t _threshold;
+    bool _auto;
+    time_t _median;
+    unsigned long _readAt;  // millis() of the last read()
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ * DS3232Format.cpp - fixed width text for DS3232 times and alarms, without Print or heap
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "DS3232Format.h"
+
+// "00" to "99", two characters per value
+static const char digitPairs[201] PROGMEM =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+static const uint8_t daysInMonth[12] PROGMEM = {
+  31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+// Fields matched by each alarmMode_t; 1=seconds, 2=minutes, 4=hours, 8=date/day
+static const uint8_t alarmFields[] PROGMEM = {
+  0x00,  // alarmModeUnknown
+  0x00,  // alarmModePerSecond
+  0x00,  // alarmModePerMinute
+  0x01,  // alarmModeSecondsMatch
+  0x03,  // alarmModeMinutesMatch
+  0x07,  // alarmModeHoursMatch
+  0x0F,  // alarmModeDateMatch
+  0x0F,  // alarmModeDayMatch
+  0x00   // alarmModeOff
+};
+
+#define FIELD_ANY   0xFF  // "**"
+#define FIELD_BAD   0xFE
+
+/**
+ * \brief Write num (0~99) as two digits
+ */
+static inline void put2(char *p, uint8_t num) {
+  if (num > 99) num = 99;
+  p[0] = pgm_read_byte(&digitPairs[num * 2]);
+  p[1] = pgm_read_byte(&digitPairs[num * 2 + 1]);
+}
+
+/**
+ * \brief Read two digits, FIELD_BAD if either is not a digit
+ */
+static inline uint8_t get2(const char *p) {
+  uint8_t hi = (uint8_t)(p[0] - '0');
+  uint8_t lo = (uint8_t)(p[1] - '0');
+  if ((hi > 9) || (lo > 9)) return FIELD_BAD;
+  return hi * 10 + lo;
+}
+
+/**
+ * \brief Read an alarm field, two digits or "**"
+ */
+static inline uint8_t getField(const char *p) {
+  if ((p[0] == '*') && (p[1] == '*')) return FIELD_ANY;
+  return get2(p);
+}
+
+/**
+ * \brief Day of week (1~7, 1 = Sunday) for a calendar date
+ */
+static uint8_t dayOfWeek(uint16_t y, uint8_t m, uint8_t d) {
+  static const uint8_t t[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+  if (m < 3) y--;
+  return ((y + y / 4 - y / 100 + y / 400 + t[m - 1] + d) % 7) + 1;
+}
+
+/**
+ * \brief Write tm as "YYYY-MM-DDTHH:MM:SS", returns DS3232_ISO8601_LEN
+ */
+size_t formatISO8601(char *buf, const tmElements_t &tm) {
+  uint16_t year = tmYearToCalendar(tm.Year);
+  put2(buf, year / 100);
+  put2(buf + 2, year % 100);
+  buf[4] = '-';
+  put2(buf + 5, tm.Month);
+  buf[7] = '-';
+  put2(buf + 8, tm.Day);
+  buf[10] = 'T';
+  put2(buf + 11, tm.Hour);
+  buf[13] = ':';
+  put2(buf + 14, tm.Minute);
+  buf[16] = ':';
+  put2(buf + 17, tm.Second);
+  buf[19] = '\0';
+  return DS3232_ISO8601_LEN;
+}
+
+/**
+ * \brief Parse "YYYY-MM-DDTHH:MM:SS" (a space may replace the 'T')
+ * Wday is computed from the date.
+ */
+bool parseISO8601(const char *str, tmElements_t &tm) {
+  uint8_t i, y1, y2, mo, d, h, mi, s;
+  uint16_t year;
+
+  for (i = 0; i < DS3232_ISO8601_LEN; i++) {
+    if (str[i] == '\0') return false;
+  }
+  if ((str[4] != '-') || (str[7] != '-') || (str[13] != ':') || (str[16] != ':')) return false;
+  if ((str[10] != 'T') && (str[10] != ' ')) return false;
+
+  y1 = get2(str);
+  y2 = get2(str + 2);
+  mo = get2(str + 5);
+  d  = get2(str + 8);
+  h  = get2(str + 11);
+  mi = get2(str + 14);
+  s  = get2(str + 17);
+  if ((y1 | y2 | mo | d | h | mi | s) & 0x80) return false;  // FIELD_BAD
+
+  year = y1 * 100 + y2;
+  if ((year < 2000) || (year > 2199)) return false;  // century bit covers 2000~2199
+  if ((mo < 1) || (mo > 12) || (d < 1) || (h > 23) || (mi > 59) || (s > 59)) return false;
+  if (d > pgm_read_byte(&daysInMonth[mo - 1])) return false;
+  if ((mo == 2) && (d == 29) &&
+      (((year % 4) != 0) || (((year % 100) == 0) && ((year % 400) != 0)))) return false;
+
+  tm.Year = CalendarYrToTm(year);
+  tm.Month = mo;
+  tm.Day = d;
+  tm.Hour = h;
+  tm.Minute = mi;
+  tm.Second = s;
+  tm.Wday = dayOfWeek(year, mo, d);
+  return true;
+}
+
+/**
+ * \brief Write an alarm descriptor (see DS3232Format.h), returns DS3232_ALARM_LEN
+ */
+size_t formatAlarm(char *buf, alarmMode_t mode, const tmElements_t &tm) {
+  uint8_t fields;
+
+  if ((mode >= alarmModeOff) || (mode == alarmModeUnknown)) {
+    memcpy(buf, (mode == alarmModeOff) ? "OFFT--:--:--" : "???T??:??:??", DS3232_ALARM_LEN);
+    buf[DS3232_ALARM_LEN] = '\0';
+    return DS3232_ALARM_LEN;
+  }
+
+  memcpy(buf, "***T**:**:**", DS3232_ALARM_LEN);
+  fields = pgm_read_byte(&alarmFields[mode]);
+  if (mode == alarmModeDateMatch) {
+    buf[0] = 'D';
+    put2(buf + 1, tm.Day);
+  } else if (mode == alarmModeDayMatch) {
+    buf[0] = 'W';
+    put2(buf + 1, tm.Wday);
+  }
+  if (fields & 0x04) put2(buf + 4, tm.Hour);
+  if (fields & 0x02) put2(buf + 7, tm.Minute);
+  if (fields & 0x01) put2(buf + 10, tm.Second);
+  if (mode == alarmModePerMinute) put2(buf + 10, 0);
+  buf[DS3232_ALARM_LEN] = '\0';
+  return DS3232_ALARM_LEN;
+}
+
+/**
+ * \brief Parse an alarm descriptor (see DS3232Format.h)
+ * Matched fields must run from the seconds up, e.g. "***T**:30:00" but not "***T12:**:00".
+ */
+bool parseAlarm(const char *str, alarmMode_t &mode, tmElements_t &tm) {
+  uint8_t i, h, mi, s, day = 0, fields;
+  char sel;
+
+  for (i = 0; i < DS3232_ALARM_LEN; i++) {
+    if (str[i] == '\0') return false;
+  }
+  if ((str[3] != 'T') || (str[6] != ':') || (str[9] != ':')) return false;
+
+  if (strncmp(str, "OFF", 3) == 0) {
+    memset(&tm, 0, sizeof(tmElements_t));
+    mode = alarmModeOff;
+    return true;
+  }
+
+  h  = getField(str + 4);
+  mi = getField(str + 7);
+  s  = getField(str + 10);
+  if ((h == FIELD_BAD) || (mi == FIELD_BAD) || (s == FIELD_BAD)) return false;
+
+  sel = str[0];
+  if (sel == '*') {
+    if ((str[1] != '*') || (str[2] != '*')) return false;
+  } else if ((sel == 'D') || (sel == 'W')) {
+    day = get2(str + 1);
+    if ((day == 0) || (day > ((sel == 'D') ? 31 : 7))) return false;
+  } else {
+    return false;
+  }
+  if (((h != FIELD_ANY) && (h > 23)) || ((mi != FIELD_ANY) && (mi > 59)) ||
+      ((s != FIELD_ANY) && (s > 59))) return false;
+
+  fields = ((s != FIELD_ANY) ? 0x01 : 0) | ((mi != FIELD_ANY) ? 0x02 : 0) |
+    ((h != FIELD_ANY) ? 0x04 : 0) | ((day != 0) ? 0x08 : 0);
+  if ((fields & (fields + 1)) != 0) return false;  // must be 0, 1, 3, 7 or 15
+
+  switch (fields) {
+    case 0x00: mode = alarmModePerSecond; break;
+    case 0x01: mode = alarmModeSecondsMatch; break;
+    case 0x03: mode = alarmModeMinutesMatch; break;
+    case 0x07: mode = alarmModeHoursMatch; break;
+    default: mode = (sel == 'D') ? alarmModeDateMatch : alarmModeDayMatch; break;
+  }
+  memset(&tm, 0, sizeof(tmElements_t));
+  if (fields & 0x01) tm.Second = s;
+  if (fields & 0x02) tm.Minute = mi;
+  if (fields & 0x04) tm.Hour = h;
+  if (sel == 'D') tm.Day = day;
+  if (sel == 'W') tm.Wday = day;
+  return true;
+}
@@ -0,0 +1,42 @@
+/*
+ * DS3232Format.h - fixed width text for DS3232 times and alarms, without Print or heap
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#ifndef DS3232Format_h
+#define DS3232Format_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <TimeLib.h> // http://playground.arduino.cc/Code/time
+#include "DS3232RTC.h"
+
+/*
+  Timestamp: "YYYY-MM-DDTHH:MM:SS" (ISO 8601 extended, no zone)
+             the time alone starts at offset DS3232_ISO8601_TIME;
+             parsed years are limited to those the RTC holds, 2000~2199
+
+  Alarm:     "DDDTHH:MM:SS" where DDD is
+               "***"   any day
+               "Dnn"   date (of month) nn
+               "Wnn"   day (of week) nn, 01 = Sunday
+               "OFF"   alarm off (fields are "--")
+               "???"   unknown mode (fields are "??")
+             and any of HH, MM, SS may be "**" when not matched.
+             alarmModePerMinute is "***T**:**:00", which parses back as
+             alarmModeSecondsMatch; writeAlarm(2, ...) programs both the same.
+*/
+#define DS3232_ISO8601_LEN    19
+#define DS3232_ISO8601_TIME   11
+#define DS3232_ALARM_LEN      12
+
+// Each writes exactly *_LEN characters plus a terminating '\0'
+size_t formatISO8601(char *buf, const tmElements_t &tm);
+size_t formatAlarm(char *buf, alarmMode_t mode, const tmElements_t &tm);
+// Return false (tm untouched) when str is malformed or out of range
+bool parseISO8601(const char *str, tmElements_t &tm);
+bool parseAlarm(const char *str, alarmMode_t &mode, tmElements_t &tm);
+
+#endif
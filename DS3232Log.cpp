@@ -0,0 +1,211 @@
+/*
+ * DS3232Log.cpp - compact event log kept in the DS3232 battery-backed SRAM
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#include <stdint.h>
+#include "DS3232Log.h"
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3232Log Class                                                      | */
+/* +----------------------------------------------------------------------+ */
+
+/**
+ * \brief Use size bytes of SRAM from offset start, codeBits (1~7) per event code
+ */
+DS3232Log::DS3232Log(uint8_t start, uint8_t size, uint8_t codeBits)
+  : _start(start)
+  , _size(size)
+  , _bits(codeBits)
+  , _used(0)
+  , _base(0)
+  , _last(0)
+  , _rpos(0)
+  , _rtime(0)
+  , _wpos(0)
+  , _wlen(0)
+{
+  if (_start > DS3232_SRAM_SIZE) _start = DS3232_SRAM_SIZE;
+  if (_size > DS3232_SRAM_SIZE - _start) _size = DS3232_SRAM_SIZE - _start;
+  if (_bits < 1) _bits = 1;
+  if (_bits > 7) _bits = 7;
+}
+
+/**
+ * \brief Write an empty log with the given base epoch
+ */
+bool DS3232Log::begin(time_t base) {
+  uint8_t hdr[DS3232LOG_HEADER];
+  uint32_t b = (uint32_t)base;
+
+  if (_size <= DS3232LOG_HEADER) return false;
+  hdr[0] = DS3232LOG_MAGIC;
+  hdr[1] = _bits;
+  hdr[2] = b & 0xFF;
+  hdr[3] = (b >> 8) & 0xFF;
+  hdr[4] = (b >> 16) & 0xFF;
+  hdr[5] = (b >> 24) & 0xFF;
+  hdr[6] = 0;
+  if (SRAM.write(_start, hdr, DS3232LOG_HEADER) != DS3232LOG_HEADER) return false;
+  _used = 0;
+  _base = base;
+  _last = base;
+  rewind();
+  return true;
+}
+
+/**
+ * \brief Attach to a log previously written with begin()
+ * Scans the records once to find the time of the last one.
+ */
+bool DS3232Log::open() {
+  uint8_t hdr[DS3232LOG_HEADER];
+  time_t t;
+  uint8_t code;
+
+  if (_size <= DS3232LOG_HEADER) return false;
+  if (SRAM.read(_start, hdr, DS3232LOG_HEADER) != DS3232LOG_HEADER) return false;
+  if ((hdr[0] != DS3232LOG_MAGIC) || (hdr[1] != _bits)) return false;
+  if (hdr[6] > _size - DS3232LOG_HEADER) return false;
+
+  _base = (time_t)((uint32_t)hdr[2] | ((uint32_t)hdr[3] << 8) |
+    ((uint32_t)hdr[4] << 16) | ((uint32_t)hdr[5] << 24));
+  _used = hdr[6];
+  _last = _base;
+  rewind();
+  while (next(t, code)) _last = t;
+  if (_rpos != _used) {
+    // truncated record at the end, drop it
+    _used = _rpos;
+    writeUsed();
+  }
+  rewind();
+  return true;
+}
+
+/**
+ * \brief Add an event, returns false when the log is full or t is before the last event
+ */
+bool DS3232Log::append(time_t t, uint8_t code) {
+  uint8_t buf[DS3232LOG_MAX_VARINT];
+  uint8_t n;
+
+  if (t < _last) return false;
+  n = encode(buf, (uint32_t)(t - _last), code, _bits);
+  if ((n == 0) || (n > remaining())) return false;
+  if (SRAM.write(_start + DS3232LOG_HEADER + _used, buf, n) != n) return false;
+  _used += n;
+  writeUsed();
+  _last = t;
+  return true;
+}
+
+/**
+ * \brief Number of record bytes in use
+ */
+uint8_t DS3232Log::used() {
+  return _used;
+}
+
+/**
+ * \brief Number of record bytes still free
+ */
+uint8_t DS3232Log::remaining() {
+  if (_size <= DS3232LOG_HEADER) return 0;
+  return _size - DS3232LOG_HEADER - _used;
+}
+
+/**
+ *
+ */
+time_t DS3232Log::base() {
+  return _base;
+}
+
+/**
+ * \brief Time of the most recent event (or the base epoch when empty)
+ */
+time_t DS3232Log::last() {
+  return _last;
+}
+
+/**
+ * \brief Restart reading from the first record
+ */
+void DS3232Log::rewind() {
+  _rpos = 0;
+  _rtime = _base;
+  _wpos = 0;
+  _wlen = 0;
+}
+
+/**
+ * \brief Decode the next record, returns false at the end of the log
+ * SRAM is read in small bursts, records are never copied out as a whole.
+ */
+bool DS3232Log::next(time_t &t, uint8_t &code) {
+  uint32_t delta;
+  uint8_t n;
+
+  if (_rpos >= _used) return false;
+  if ((_rpos < _wpos) ||
+      ((_rpos + DS3232LOG_MAX_VARINT > _wpos + _wlen) && (_wpos + _wlen < _used))) {
+    _wpos = _rpos;
+    _wlen = _used - _rpos;
+    if (_wlen > sizeof(_win)) _wlen = sizeof(_win);
+    _wlen = SRAM.read(_start + DS3232LOG_HEADER + _wpos, _win, _wlen);
+  }
+  n = decode(_win + (_rpos - _wpos), _wpos + _wlen - _rpos, delta, code, _bits);
+  if (n == 0) return false;
+  _rpos += n;
+  _rtime += delta;
+  t = _rtime;
+  return true;
+}
+
+/**
+ * \brief Encode one record into buf (at least DS3232LOG_MAX_VARINT bytes)
+ * Returns the number of bytes used, or 0 if delta does not fit.
+ */
+uint8_t DS3232Log::encode(uint8_t *buf, uint32_t delta, uint8_t code, uint8_t codeBits) {
+  uint32_t value;
+  uint8_t n = 0;
+
+  if (delta > (0xFFFFFFFFUL >> codeBits)) return 0;
+  value = (delta << codeBits) | (code & ((1 << codeBits) - 1));
+  while (value >= 0x80) {
+    buf[n++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  buf[n++] = value;
+  return n;
+}
+
+/**
+ * \brief Decode one record from buf (len bytes available)
+ * Returns the number of bytes consumed, or 0 if the record is truncated.
+ */
+uint8_t DS3232Log::decode(const uint8_t *buf, uint8_t len, uint32_t &delta, uint8_t &code, uint8_t codeBits) {
+  uint32_t value = 0;
+  uint8_t i;
+
+  if (len > DS3232LOG_MAX_VARINT) len = DS3232LOG_MAX_VARINT;
+  for (i = 0; i < len; i++) {
+    value |= (uint32_t)(buf[i] & 0x7F) << (7 * i);
+    if ((buf[i] & 0x80) == 0) {
+      code = value & ((1 << codeBits) - 1);
+      delta = value >> codeBits;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ *
+ */
+void DS3232Log::writeUsed() {
+  SRAM.write(_start + 6, _used);
+}
@@ -0,0 +1,71 @@
+/*
+ * DS3232Log.h - compact event log kept in the DS3232 battery-backed SRAM
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#ifndef DS3232Log_h
+#define DS3232Log_h
+
+#include <stdint.h>
+#include <TimeLib.h> // http://playground.arduino.cc/Code/time
+#include "DS3232RTC.h"
+
+/*
+  Log layout, starting at the SRAM offset given to the constructor:
+
+    +0  magic (DS3232LOG_MAGIC)
+    +1  bits used for the event code (1~7)
+    +2  base epoch, time_t little endian (4 bytes)
+    +6  number of record bytes in use
+    +7  records
+
+  Each record is a single varint (7 bits per byte, LSB first, MSB set on
+  all but the last byte) holding (delta << codeBits) | code, where delta
+  is the number of seconds since the previous record (or the base epoch).
+  With the default 4 code bits an event within 7 seconds of the last one
+  takes 1 byte, within ~17 minutes 2 bytes, within ~36 hours 3 bytes.
+*/
+#define DS3232LOG_MAGIC     0xD5
+#define DS3232LOG_HEADER    7
+#define DS3232LOG_MAX_VARINT 5
+
+/**
+ * DS3232Log Class
+ */
+class DS3232Log
+{
+  public:
+    DS3232Log(uint8_t start = 0, uint8_t size = DS3232_SRAM_SIZE, uint8_t codeBits = 4);
+    // Writer
+    bool begin(time_t base);  // formats an empty log
+    bool open();              // attaches to an existing log
+    bool append(time_t t, uint8_t code);
+    uint8_t used();
+    uint8_t remaining();
+    time_t base();
+    time_t last();
+    // Reader
+    void rewind();
+    bool next(time_t &t, uint8_t &code);
+    // Codec, no SRAM access
+    static uint8_t encode(uint8_t *buf, uint32_t delta, uint8_t code, uint8_t codeBits);
+    static uint8_t decode(const uint8_t *buf, uint8_t len, uint32_t &delta, uint8_t &code, uint8_t codeBits);
+  private:
+    void writeUsed();
+    uint8_t _start;
+    uint8_t _size;
+    uint8_t _bits;
+    uint8_t _used;
+    time_t _base;
+    time_t _last;
+    // read window
+    uint8_t _rpos;
+    time_t _rtime;
+    uint8_t _wpos;
+    uint8_t _wlen;
+    uint8_t _win[8];
+};
+
+#endif
@@ -5,66 +5,134 @@
  (See DS3232RTC.h for notes & license)
  */
 
-#include <Stdint.h>
+#include <stdint.h>
 #include <Wire.h>
 #include <Stream.h>
 #include "DS3232RTC.h"
+#include "DS3232Regs.h"
+#include "DS3232Decode.h"
 
-// Bits in the Control register
-// Based on page 13 of specs; http://www.maxim-ic.com/datasheet/index.mvp/id/4984
-#define DS3232_EOSC         0x80
-#define DS3232_BBSQW        0x40
-#define DS3232_CONV         0x20
-#define DS3232_RS2          0x10
-#define DS3232_RS1          0x08
-#define DS3232_INTCN        0x04
-#define DS3232_A2IE         0x02
-#define DS3232_A1IE         0x01
-
-#define DS3232_RS_1HZ       0x00
-#define DS3232_RS_1024HZ    0x08
-#define DS3232_RS_4096HZ    0x10
-#define DS3232_RS_8192HZ    0x18
-
-// Bits in the Status register
-// Based on page 14 of specs; http://www.maxim-ic.com/datasheet/index.mvp/id/4984
-#define DS3232_OSF          0x80
-#define DS3232_BB33KHZ      0x40
-#define DS3232_CRATE1       0x20
-#define DS3232_CRATE0       0x10
-#define DS3232_EN33KHZ      0x08
-#define DS3232_BSY          0x04
-#define DS3232_A2F          0x02
-#define DS3232_A1F          0x01
-
-#define DS3232_CRATE_64     0x00
-#define DS3232_CRATE_128    0x10
-#define DS3232_CRATE_256    0x20
-#define DS3232_CRATE_512    0x30
+// Wire library transmit/receive buffer size
+#define DS3232_WIRE_CHUNK   32
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3232Bus Class                                                      | */ 
+/* +----------------------------------------------------------------------+ */
+
+/**
+ * \brief Read SRAM, on the DS3232 it is mapped at register 14h
+ */
+uint8_t DS3232Bus::readSRAM(uint8_t addr, uint8_t *buf, uint8_t size) {
+  return read(0x14 + addr, buf, size);
+}
+
+/**
+ * \brief Write SRAM, on the DS3232 it is mapped at register 14h
+ */
+uint8_t DS3232Bus::writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  return write(0x14 + addr, buf, size);
+}
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3232Wire Class                                                     | */ 
+/* +----------------------------------------------------------------------+ */
+
+/**
+ *
+ */
+void DS3232Wire::begin() {
+  _wire->begin();
+}
+
+/**
+ * \brief Burst read from register addr
+ * Split into requests that fit the Wire buffer
+ */
+uint8_t DS3232Wire::read(uint8_t addr, uint8_t *buf, uint8_t size) {
+  uint8_t i = 0;
+  while (i < size) {
+    uint8_t n = size - i;
+    if (n > DS3232_WIRE_CHUNK) n = DS3232_WIRE_CHUNK;
+    _wire->beginTransmission(_address);
+    _wire->write(addr + i);
+    _wire->endTransmission();
+    _wire->requestFrom(_address, n);
+    if (_wire->available() < n) break;
+    while (n--) buf[i++] = _wire->read();
+  }
+  return i;
+}
+
+/**
+ * \brief Burst write from register addr
+ */
+uint8_t DS3232Wire::write(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  uint8_t i = 0;
+  while (i < size) {
+    uint8_t n = size - i;
+    if (n > DS3232_WIRE_CHUNK - 1) n = DS3232_WIRE_CHUNK - 1;  // less the address byte
+    _wire->beginTransmission(_address);
+    _wire->write(addr + i);
+    _wire->write(buf + i, n);
+    if (_wire->endTransmission() != 0) break;
+    i += n;
+  }
+  return i;
+}
 
 /* +----------------------------------------------------------------------+ */
 /* | DS3232RTC Class                                                      | */ 
 /* +----------------------------------------------------------------------+ */
 
+#define PROBE_UNKNOWN 0
+#define PROBE_ABSENT  1
+#define PROBE_PRESENT 2
+
+static DS3232Wire defaultBus;
+DS3232Bus *DS3232RTC::_bus = &defaultBus;
+bool DS3232RTC::_begun = false;
+uint8_t DS3232RTC::_probe = PROBE_UNKNOWN;
+
+/**
+ * \brief Start the bus, called on first use if the sketch does not
+ */
+void DS3232RTC::begin() {
+  _begun = true;
+  _bus->begin();
+}
+
+/**
+ * \brief Talk to the RTC through another transport, e.g. DS3234SPI
+ */
+void DS3232RTC::setBus(DS3232Bus &bus) {
+  _bus = &bus;
+  _begun = false;
+  _probe = PROBE_UNKNOWN;
+}
+
 /**
  *
  */
-DS3232RTC::DS3232RTC() {
-  Wire.begin();
+DS3232Bus &DS3232RTC::bus() {
+  if (!_begun) begin();
+  return *_bus;
 }
+
 /**
- *  
+ * \brief Is the RTC on the bus; probed once, shared with SRAM.available()
  */
 bool DS3232RTC::available() {
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(0x05);  // sends 05h - month register
-  Wire.endTransmission();
-  Wire.requestFrom(DS3232_I2C_ADDRESS, 1);
-  if (Wire.available()) {
-    uint8_t dummy = Wire.read();
-    return true;
-  }
-  return false;
+  if (_probe == PROBE_UNKNOWN) reprobe();
+  return (_probe == PROBE_PRESENT);
+}
+
+/**
+ * \brief Probe the bus again, e.g. after the module was connected
+ */
+bool DS3232RTC::reprobe() {
+  uint8_t dummy;
+  _probe = (bus().read(0x05, &dummy, 1) == 1) ? PROBE_PRESENT : PROBE_ABSENT;  // 05h - month register
+  return (_probe == PROBE_PRESENT);
 }
   
 /**
@@ -89,30 +157,10 @@ void DS3232RTC::set(time_t t) {
  *
  */
 void DS3232RTC::read( tmElements_t &tm ) { 
-  uint8_t b;
-
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(0);  // sends 00h - seconds register
-  Wire.endTransmission();
-  Wire.requestFrom(DS3232_I2C_ADDRESS, 7);
-
-  if (Wire.available()) {
-    tm.Second = bcd2dec(Wire.read() & 0x7F);  // 00h
-    tm.Minute = bcd2dec(Wire.read() & 0x7F);  // 01h
-    b = Wire.read() & 0x7F;                   // 02h
-    if ((b & 0x40) != 0) {  // 12 hour format with bit 5 set as PM
-      tm.Hour = bcd2dec(b & 0x1F);
-      if ((b & 0x20) != 0) tm.Hour += 12;
-    } else {  // 24 hour format
-      tm.Hour = bcd2dec(b & 0x3F);
-    }
-    tm.Wday =  bcd2dec(Wire.read() & 0x07);   // 03h
-    tm.Day =   bcd2dec(Wire.read() & 0x3F);   // 04h
-    b = Wire.read() & 0x9F;                   // 05h
-    tm.Month = bcd2dec(b & 0x1F);
-    tm.Year =  bcd2dec(Wire.read());   // 06h
-    if ((b & 0x80) != 0) tm.Year += 100;
-    tm.Year = y2kYearToTm(tm.Year);
+  uint8_t data[7];
+
+  if (bus().read(0x00, data, 7) == 7) {  // 00h - seconds register
+    decodeTime(data, tm);
   }
 }
 
@@ -120,10 +168,9 @@ void DS3232RTC::read( tmElements_t &tm ) {
  *
  */
 void DS3232RTC::writeTime(tmElements_t &tm) {
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(0);  // sends 00h - seconds register
-  _wTime(tm);
-  Wire.endTransmission();
+  uint8_t data[3];
+  _wTime(tm, data);
+  bus().write(0x00, data, 3);  // sends 00h - seconds register
   setOscillatorStopFlag(false);
 }
 
@@ -131,21 +178,18 @@ void DS3232RTC::writeTime(tmElements_t &tm) {
  *
  */
 void DS3232RTC::writeDate(tmElements_t &tm) {
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(3);  // sends 03h - day (of week) register
-  _wDate(tm);
-  Wire.endTransmission();
+  uint8_t data[4];
+  _wDate(tm, data);
+  bus().write(0x03, data, 4);  // sends 03h - day (of week) register
 }
 
 /**
  *
  */
 void DS3232RTC::write(tmElements_t &tm) {
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(0);  // sends 00h - seconds register
-  _wTime(tm);
-  _wDate(tm);
-  Wire.endTransmission();
+  uint8_t data[7];
+  encodeTime(tm, data);
+  bus().write(0x00, data, 7);  // sends 00h - seconds register
   setOscillatorStopFlag(false);
 }
 
@@ -155,68 +199,22 @@ void DS3232RTC::write(tmElements_t &tm) {
  */
 void DS3232RTC::readAlarm(uint8_t alarm, alarmMode_t &mode, tmElements_t &tm) {
   uint8_t data[4];
-  uint8_t flags;
-  int i;
+  alarmElements_t a;
 
   memset(&tm, 0, sizeof(tmElements_t));
   mode = alarmModeUnknown;
   if ((alarm > 2) || (alarm < 1)) return;
 
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write( ((alarm == 1) ? 0x07 : 0x0B) );
-  Wire.endTransmission();
-  Wire.requestFrom( DS3232_I2C_ADDRESS, ((alarm == 1) ? 4 : 3) );
-  if (Wire.available()) {
-    if (alarm == 1) {
-      for (i = 0; i < 4; i++) data[i] = Wire.read();
-    } else {
-      data[0] = 0;  // alarm 2 doesn't use seconds
-      for (i = 1; i < 4; i++) data[i] = Wire.read();
-    }
-
-    flags = ((data[0] & 0x80) >> 7) | ((data[1] & 0x80) >> 6) |
-      ((data[2] & 0x80) >> 5) | ((data[3] & 0x80) >> 4);
-    if (flags == 0) flags = ((data[3] & 0x40) >> 2);
-    switch (flags) {
-      case 0x04: mode = alarmModePerSecond; break;  // X1111
-      case 0x0E: mode = (alarm == 1) ? alarmModeSecondsMatch : alarmModePerMinute; break;  // X1110
-      case 0x0A: mode = alarmModeMinutesMatch; break;  // X1100
-      case 0x08: mode = alarmModeHoursMatch; break;  // X1000
-      case 0x00: mode = alarmModeDateMatch; break;  // 00000
-      case 0x10: mode = alarmModeDayMatch; break;  // 10000
-    }
-
-    if (alarm == 1) tm.Second = bcd2dec(data[0] & 0x7F);
-    tm.Minute = bcd2dec(data[1] & 0x7F);
-    if ((data[2] & 0x40) != 0) {
-      // 12 hour format with bit 5 set as PM
-      tm.Hour = bcd2dec(data[2] & 0x1F);
-      if ((data[2] & 0x20) != 0) tm.Hour += 12;
-    } else {
-      // 24 hour format
-      tm.Hour = bcd2dec(data[2] & 0x3F);
-    }
-    if ((data[3] & 0x40) == 0) {
-      // Alarm holds Date (of Month)
-      tm.Day = bcd2dec(data[3] & 0x3F);
-    } else {
-      // Alarm holds Day (of Week)
-      tm.Wday = bcd2dec(data[3] & 0x07);
-    }
+  data[0] = 0;  // alarm 2 doesn't use seconds
+  if ((alarm == 1) ? (bus().read(0x07, data, 4) == 4) : (bus().read(0x0B, data + 1, 3) == 3)) {
 
-    // TODO : Not too sure about this.
-    /*
-      If the alarm is set to trigger every Nth of the month
-      (or every 1-7 week day), but the date/day are 0 then
-      what?  The spec is not clear about alarm off conditions.
-      My assumption is that it would not trigger is date/day
-      set to 0, so I've created a Alarm-Off mode.
-    */
-    if ((mode == alarmModeDateMatch) && (tm.Day == 0)) {
-      mode = alarmModeOff;
-    } else if ((mode == alarmModeDayMatch) && (tm.Wday == 0)) {
-      mode = alarmModeOff;
-    }
+    ds3232DecodeAlarm(alarm, data, a);
+    mode = a.Mode;
+    tm.Second = a.Second;
+    tm.Minute = a.Minute;
+    tm.Hour = a.Hour;
+    tm.Day = a.Day;
+    tm.Wday = a.Wday;
   }
 }
 
@@ -226,65 +224,12 @@ void DS3232RTC::readAlarm(uint8_t alarm, alarmMode_t &mode, tmElements_t &tm) {
 void DS3232RTC::writeAlarm(uint8_t alarm, alarmMode_t mode, tmElements_t tm) {
   uint8_t data[4];
 
-  switch (mode) {
-    case alarmModePerSecond:
-      data[0] = 0x80;
-      data[1] = 0x80;
-      data[2] = 0x80;
-      data[3] = 0x80;
-      break;
-    case alarmModePerMinute:
-      data[0] = 0x00;
-      data[1] = 0x80;
-      data[2] = 0x80;
-      data[3] = 0x80;
-      break;
-    case alarmModeSecondsMatch:
-      data[0] = 0x00 | dec2bcd(tm.Second);
-      data[1] = 0x80;
-      data[2] = 0x80;
-      data[3] = 0x80;
-      break;
-    case alarmModeMinutesMatch:
-      data[0] = 0x00 | dec2bcd(tm.Second);
-      data[1] = 0x00 | dec2bcd(tm.Minute);
-      data[2] = 0x80;
-      data[3] = 0x80;
-      break;
-    case alarmModeHoursMatch:
-      data[0] = 0x00 | dec2bcd(tm.Second);
-      data[1] = 0x00 | dec2bcd(tm.Minute);
-      data[2] = 0x00 | dec2bcd(tm.Hour);
-      data[3] = 0x80;
-      break;
-    case alarmModeDateMatch:
-      data[0] = 0x00 | dec2bcd(tm.Second);
-      data[1] = 0x00 | dec2bcd(tm.Minute);
-      data[2] = 0x00 | dec2bcd(tm.Hour);
-      data[3] = 0x00 | dec2bcd(tm.Day);
-      break;
-    case alarmModeDayMatch:
-      data[0] = 0x00 | dec2bcd(tm.Second);
-      data[1] = 0x00 | dec2bcd(tm.Minute);
-      data[2] = 0x00 | dec2bcd(tm.Hour);
-      data[3] = 0x40 | dec2bcd(tm.Wday);
-      break;
-    case alarmModeOff:
-      data[0] = 0x00;
-      data[1] = 0x00;
-      data[2] = 0x00;
-      data[3] = 0x00;
-      break;
-    default: return;
+  if (!encodeAlarm(mode, tm, data)) return;
+  if (alarm == 1) {
+    bus().write(0x07, data, 4);
+  } else {
+    bus().write(0x0B, data + 1, 3);
   }
-
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write( ((alarm == 1) ? 0x07 : 0x0B) );
-  if (alarm == 1) Wire.write(data[0]);
-  Wire.write(data[1]);
-  Wire.write(data[2]);
-  Wire.write(data[3]);
-  Wire.endTransmission();
 }
 
 /**
@@ -315,21 +260,29 @@ void DS3232RTC::setBBSqareWave(bool enable) {
   write1(0x0E, value);  // sends 0Eh - Control register
 }
 
+/**
+ * \brief Low 5 bits of the Control register for an SQI mode
+ */
+static uint8_t sqiControl(sqiMode_t mode) {
+  switch (mode) {
+    case sqiModeNone: return DS3232_INTCN;
+    case sqiMode1Hz: return DS3232_RS_1HZ;
+    case sqiMode1024Hz: return DS3232_RS_1024HZ;
+    case sqiMode4096Hz: return DS3232_RS_4096HZ;
+    case sqiMode8192Hz: return DS3232_RS_8192HZ;
+    case sqiModeAlarm1: return (DS3232_INTCN | DS3232_A1IE);
+    case sqiModeAlarm2: return (DS3232_INTCN | DS3232_A2IE);
+    case sqiModeAlarmBoth: return (DS3232_INTCN | DS3232_A1IE | DS3232_A2IE);
+  }
+  return 0;
+}
+
 /**
  * \brief Set the SQI pin to either a square wave generator or an alarm interupt
  */
 void DS3232RTC::setSQIMode(sqiMode_t mode) {
   uint8_t value = read1(0x0E) & 0xE0;  // sends 0Eh - Control register
-  switch (mode) {
-    case sqiModeNone: value |= DS3232_INTCN; break;
-    case sqiMode1Hz: value |= DS3232_RS_1HZ;  break;
-    case sqiMode1024Hz: value |= DS3232_RS_1024HZ; break;
-    case sqiMode4096Hz: value |= DS3232_RS_4096HZ; break;
-    case sqiMode8192Hz: value |= DS3232_RS_8192HZ; break;
-    case sqiModeAlarm1: value |= (DS3232_INTCN | DS3232_A1IE); break;
-    case sqiModeAlarm2: value |= (DS3232_INTCN | DS3232_A2IE); break;
-    case sqiModeAlarmBoth: value |= (DS3232_INTCN | DS3232_A1IE | DS3232_A2IE); break;
-  }
+  value |= sqiControl(mode);
   write1(0x0E, value);  // sends 0Eh - Control register
 }
 
@@ -446,21 +399,97 @@ void DS3232RTC::clearAlarmFlag(uint8_t alarm) {
  *
  */
 void DS3232RTC::readTemperature(tpElements_t &tmp) {
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(0x11);  // sends 11h - MSB of Temp register
-  Wire.endTransmission();
+  uint8_t data[2];
 
-  Wire.requestFrom(DS3232_I2C_ADDRESS, 2);
-
-  if (Wire.available()) {
-    tmp.Temp = Wire.read();
-    tmp.Decimal = (Wire.read() >> 6) * 25;
+  if (bus().read(0x11, data, 2) == 2) {  // 11h - MSB of Temp register
+    tmp.Temp = data[0];
+    tmp.Decimal = (data[1] >> 6) * 25;
   } else {
     tmp.Temp = NO_TEMPERATURE;
     tmp.Decimal = NO_TEMPERATURE;
   }
 }
 
+/**
+ * \brief Decode the 7 time registers (00h~06h) into tm
+ */
+void DS3232RTC::decodeTime(const uint8_t *data, tmElements_t &tm) {
+  tm.Second = bcd2dec(data[0] & 0x7F);  // 00h
+  tm.Minute = bcd2dec(data[1] & 0x7F);  // 01h
+  tm.Hour =   ds3232Hour(data[2] & 0x7F);  // 02h
+  tm.Wday =   bcd2dec(data[3] & 0x07);  // 03h
+  tm.Day =    bcd2dec(data[4] & 0x3F);  // 04h
+  tm.Month =  bcd2dec(data[5] & 0x1F);  // 05h
+  tm.Year =   y2kYearToTm(ds3232Year(data[5], data[6]));  // 06h, century in 05h
+}
+
+/**
+ * \brief Encode tm into the 7 time registers (00h~06h)
+ */
+void DS3232RTC::encodeTime(tmElements_t &tm, uint8_t *data) {
+  _wTime(tm, data);
+  _wDate(tm, data + 3);
+}
+
+/**
+ * \brief Encode an alarm into seconds, minutes, hours and day/date registers
+ * Alarm 2 (0Bh~0Dh) takes the last 3 bytes.  False for a mode that cannot be set.
+ */
+bool DS3232RTC::encodeAlarm(alarmMode_t mode, tmElements_t &tm, uint8_t *data) {
+  switch (mode) {
+    case alarmModePerSecond:
+      data[0] = 0x80;
+      data[1] = 0x80;
+      data[2] = 0x80;
+      data[3] = 0x80;
+      break;
+    case alarmModePerMinute:
+      data[0] = 0x00;
+      data[1] = 0x80;
+      data[2] = 0x80;
+      data[3] = 0x80;
+      break;
+    case alarmModeSecondsMatch:
+      data[0] = 0x00 | dec2bcd(tm.Second);
+      data[1] = 0x80;
+      data[2] = 0x80;
+      data[3] = 0x80;
+      break;
+    case alarmModeMinutesMatch:
+      data[0] = 0x00 | dec2bcd(tm.Second);
+      data[1] = 0x00 | dec2bcd(tm.Minute);
+      data[2] = 0x80;
+      data[3] = 0x80;
+      break;
+    case alarmModeHoursMatch:
+      data[0] = 0x00 | dec2bcd(tm.Second);
+      data[1] = 0x00 | dec2bcd(tm.Minute);
+      data[2] = 0x00 | dec2bcd(tm.Hour);
+      data[3] = 0x80;
+      break;
+    case alarmModeDateMatch:
+      data[0] = 0x00 | dec2bcd(tm.Second);
+      data[1] = 0x00 | dec2bcd(tm.Minute);
+      data[2] = 0x00 | dec2bcd(tm.Hour);
+      data[3] = 0x00 | dec2bcd(tm.Day);
+      break;
+    case alarmModeDayMatch:
+      data[0] = 0x00 | dec2bcd(tm.Second);
+      data[1] = 0x00 | dec2bcd(tm.Minute);
+      data[2] = 0x00 | dec2bcd(tm.Hour);
+      data[3] = 0x40 | dec2bcd(tm.Wday);
+      break;
+    case alarmModeOff:
+      data[0] = 0x00;
+      data[1] = 0x00;
+      data[2] = 0x00;
+      data[3] = 0x00;
+      break;
+    default: return false;
+  }
+  return true;
+}
+
 /**
  * \brief Convert Decimal to Binary Coded Decimal (BCD)
  */
@@ -478,45 +507,41 @@ uint8_t DS3232RTC::bcd2dec(uint8_t num) {
 /**
  *
  */
-void DS3232RTC::_wTime(tmElements_t &tm) {
-  Wire.write(dec2bcd(tm.Second)); // set seconds
-  Wire.write(dec2bcd(tm.Minute)); // set minutes
-  Wire.write(dec2bcd(tm.Hour));   // set hours [NB! sets 24 hour format]
+void DS3232RTC::_wTime(tmElements_t &tm, uint8_t *data) {
+  data[0] = dec2bcd(tm.Second); // set seconds
+  data[1] = dec2bcd(tm.Minute); // set minutes
+  data[2] = dec2bcd(tm.Hour);   // set hours [NB! sets 24 hour format]
 }
 
 /**
  *
  */
-void DS3232RTC::_wDate(tmElements_t &tm) {
+void DS3232RTC::_wDate(tmElements_t &tm, uint8_t *data) {
   uint8_t m, y;
   if (tm.Wday == 0 || tm.Wday > 7) {
     tmElements_t tm2;
     breakTime( makeTime(tm), tm2 );  // make and break to get Wday from Unix time
     tm.Wday = tm2.Wday;
   }
-  Wire.write(tm.Wday);            // set day (of week) (1~7, 1 = Sunday)
-  Wire.write(dec2bcd(tm.Day));    // set date (1~31)
+  data[0] = tm.Wday;             // set day (of week) (1~7, 1 = Sunday)
+  data[1] = dec2bcd(tm.Day);     // set date (1~31)
   y = tmYearToY2k(tm.Year);
   m = dec2bcd(tm.Month);
   if (y > 99) {
     m |= 0x80;  // MSB is Century
     y -= 100;
   }
-  Wire.write(m);                 // set month, and MSB is year >= 100
-  Wire.write(dec2bcd(y));        // set year (0~99), 100~199 flag in month
+  data[2] = m;                   // set month, and MSB is year >= 100
+  data[3] = dec2bcd(y);          // set year (0~99), 100~199 flag in month
 }
 
 /**
  *
  */
 uint8_t DS3232RTC::read1(uint8_t addr) {
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(addr);
-  Wire.endTransmission();
-
-  Wire.requestFrom(DS3232_I2C_ADDRESS, 1);
-  if (Wire.available()) {
-    return Wire.read();
+  uint8_t data;
+  if (bus().read(addr, &data, 1) == 1) {
+    return data;
   } else {
     return 0xFF;
   }
@@ -526,52 +551,180 @@ uint8_t DS3232RTC::read1(uint8_t addr) {
  *
  */
 void DS3232RTC::write1(uint8_t addr, uint8_t data){
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(addr);
-  Wire.write(data);
-  Wire.endTransmission();
+  bus().write(addr, &data, 1);
 }
 
 DS3232RTC RTC = DS3232RTC();  // instantiate for use
 
 
+/* +----------------------------------------------------------------------+ */
+/* | DS3232AlarmPlan Class                                                | */ 
+/* +----------------------------------------------------------------------+ */
+
+#define PLAN_CONTROL  7  // 0Eh
+#define PLAN_STATUS   8  // 0Fh
+
+/**
+ * \brief An empty plan
+ */
+DS3232AlarmPlan::DS3232AlarmPlan()
+  : _valid(0)
+  , _dirty(0)
+  , _sqi(0)
+  , _clear(0)
+{
+  memset(_data, 0, sizeof(_data));
+}
+
+/**
+ * \brief Read 07h~0Fh in one burst, so commit() needs no read of its own
+ * Alarms already changed in the plan keep their new values.
+ */
+bool DS3232AlarmPlan::load() {
+  uint8_t data[DS3232_PLAN_SIZE];
+  uint8_t i;
+
+  if (DS3232RTC::bus().read(0x07, data, DS3232_PLAN_SIZE) != DS3232_PLAN_SIZE) return false;
+  for (i = 0; i < DS3232_PLAN_SIZE; i++) {
+    // Control and Status changes are only merged in commit()
+    if (((_dirty & (1 << i)) == 0) || (i >= PLAN_CONTROL)) _data[i] = data[i];
+  }
+  _valid = (1 << DS3232_PLAN_SIZE) - 1;
+  return true;
+}
+
+/**
+ * \brief As DS3232RTC::writeAlarm()
+ */
+DS3232AlarmPlan &DS3232AlarmPlan::writeAlarm(uint8_t alarm, alarmMode_t mode, tmElements_t tm) {
+  uint8_t data[4];
+
+  if (!DS3232RTC::encodeAlarm(mode, tm, data)) return *this;
+  if (alarm == 1) {
+    memcpy(_data, data, 4);  // 07h~0Ah
+    mark(0, 3);
+  } else {
+    memcpy(_data + 4, data + 1, 3);  // 0Bh~0Dh
+    mark(4, 6);
+  }
+  return *this;
+}
+
+/**
+ * \brief As DS3232RTC::setSQIMode()
+ * Only the low 5 bits are the plan's; EOSC, BBSQW and CONV keep the chip's
+ * values, from load() or read back in commit().
+ */
+DS3232AlarmPlan &DS3232AlarmPlan::setSQIMode(sqiMode_t mode) {
+  _sqi = sqiControl(mode);
+  _dirty |= (1 << PLAN_CONTROL);  // the top 3 bits still have to be known
+  return *this;
+}
+
+/**
+ * \brief As DS3232RTC::clearAlarmFlag()
+ */
+DS3232AlarmPlan &DS3232AlarmPlan::clearAlarmFlag(uint8_t alarm) {
+  alarm &= (DS3232_A1F | DS3232_A2F);
+  if (alarm == 0) return *this;
+  _clear |= alarm;
+  _dirty |= (1 << PLAN_STATUS);  // the rest of Status still has to be known
+  return *this;
+}
+
+/**
+ * \brief Write the changed registers, and any between them, in one burst
+ * Registers in that span that were neither set nor loaded are read back first.
+ */
+bool DS3232AlarmPlan::commit() {
+  uint8_t data[DS3232_PLAN_SIZE];
+  uint8_t first, last, n, i;
+  uint16_t span;
+
+  if (_dirty == 0) return true;
+  for (first = 0; (_dirty & (1 << first)) == 0; first++);
+  for (last = DS3232_PLAN_SIZE - 1; (_dirty & (1 << last)) == 0; last--);
+  n = last - first + 1;
+  span = ((1 << n) - 1) << first;
+
+  if ((span & ~_valid) != 0) {
+    if (DS3232RTC::bus().read(0x07 + first, data, n) != n) return false;
+    for (i = first; i <= last; i++) {
+      if ((_valid & (1 << i)) == 0) _data[i] = data[i - first];
+    }
+    _valid |= span;
+  }
+  if ((_dirty & (1 << PLAN_CONTROL)) != 0) {
+    _data[PLAN_CONTROL] = (_data[PLAN_CONTROL] & 0xE0) | _sqi;
+  }
+  if ((_dirty & (1 << PLAN_STATUS)) != 0) {
+    // writing 1 leaves a flag as it is, OSF keeps the value read
+    _data[PLAN_STATUS] &= ~(DS3232_A1F | DS3232_A2F);
+    _data[PLAN_STATUS] |= ~_clear & (DS3232_A1F | DS3232_A2F);
+  }
+
+  if (DS3232RTC::bus().write(0x07 + first, _data + first, n) != n) return false;
+  _dirty = 0;
+  _clear = 0;
+  return true;
+}
+
+/**
+ *
+ */
+void DS3232AlarmPlan::mark(uint8_t first, uint8_t last) {
+  uint16_t bits = ((1 << (last - first + 1)) - 1) << first;
+  _valid |= bits;
+  _dirty |= bits;
+}
+
+
 /* +----------------------------------------------------------------------+ */
 /* | DS3232SRAM Class                                                      | */ 
 /* +----------------------------------------------------------------------+ */
 
 /**
- * \brief Attaches to the DS3232 RTC module on the I2C Wire
+ * \brief Attaches to the RTC module through DS3232RTC::bus()
  */
 DS3232SRAM::DS3232SRAM()
   : _cursor(0)
-  , _avail(false)
-  , _init(false)
 {
-  Wire.begin();
 }
 
 /**
  *
  */
 uint8_t DS3232SRAM::read(int addr) {
-  if (addr > 0xEC) return 0x00;
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(0x14 + addr); 
-  Wire.endTransmission();  
-  Wire.requestFrom(DS3232_I2C_ADDRESS, 1);
-  if (Wire.available()) {
-    return Wire.read();
+  uint8_t data;
+  if ((addr < 0) || (addr >= DS3232_SRAM_SIZE)) return 0x00;
+  if (DS3232RTC::bus().readSRAM(addr, &data, 1) == 1) {
+    return data;
   } else {
     return 0x00;
   }
 }
 
 void DS3232SRAM::write(int addr, uint8_t data) {
-  if (addr > 0xEC) return;
-  Wire.beginTransmission(DS3232_I2C_ADDRESS);
-  Wire.write(0x14 + addr); 
-  Wire.write(data);
-  Wire.endTransmission();  
+  if ((addr < 0) || (addr >= DS3232_SRAM_SIZE)) return;
+  DS3232RTC::bus().writeSRAM(addr, &data, 1);
+}
+
+/**
+ * \brief Read a block of SRAM starting at addr, returns the number of bytes read
+ */
+uint8_t DS3232SRAM::read(int addr, uint8_t *buf, uint8_t size) {
+  if ((addr < 0) || (addr >= DS3232_SRAM_SIZE)) return 0;
+  if (size > DS3232_SRAM_SIZE - addr) size = DS3232_SRAM_SIZE - addr;
+  return DS3232RTC::bus().readSRAM(addr, buf, size);
+}
+
+/**
+ * \brief Write a block of SRAM starting at addr, returns the number of bytes written
+ */
+uint8_t DS3232SRAM::write(int addr, const uint8_t *buf, uint8_t size) {
+  if ((addr < 0) || (addr >= DS3232_SRAM_SIZE)) return 0;
+  if (size > DS3232_SRAM_SIZE - addr) size = DS3232_SRAM_SIZE - addr;
+  return DS3232RTC::bus().writeSRAM(addr, buf, size);
 }
 
 /**
@@ -580,7 +733,7 @@ void DS3232SRAM::write(int addr, uint8_t data) {
 #if ARDUINO >= 100
 size_t DS3232SRAM::write(uint8_t data) {
 #else
-void DS3232SRAM::write(uint8_t) {
+void DS3232SRAM::write(uint8_t data) {
 #endif
   if (available() > 0) {
     write(_cursor, data);
@@ -598,23 +751,11 @@ void DS3232SRAM::write(uint8_t) {
  */
 #if ARDUINO >= 100
 size_t DS3232SRAM::write(const char *str) {
+  return write((const uint8_t *)str, strlen(str));
 #else
 void DS3232SRAM::write(const char *str) {
+  write((const uint8_t *)str, strlen(str));
 #endif
-  if (available() > 0) {
-    size_t i = 0;
-    Wire.beginTransmission(DS3232_I2C_ADDRESS);
-    Wire.write(0x14 + _cursor); 
-    while (*str && ((available() + i) > 0))
-      i += Wire.write(*str++);
-    Wire.endTransmission();
-    _cursor += i;
-    #if ARDUINO >= 100
-    return i;
-  } else {
-    return 0;
-    #endif
-  }
 }
 
 /**
@@ -625,13 +766,11 @@ size_t DS3232SRAM::write(const uint8_t *buf, size_t size) {
 #else
 void DS3232SRAM::write(const uint8_t *buf, size_t size) {
 #endif
-  if (available() > 0) {
-    size_t i = 0;
-    Wire.beginTransmission(DS3232_I2C_ADDRESS);
-    Wire.write(0x14 + _cursor); 
-    while (size-- && ((available() + i) > 0))
-      i += Wire.write(*buf++);
-    Wire.endTransmission();
+  int left = available();
+  if (left > 0) {
+    size_t i;
+    if (size > (size_t)left) size = left;
+    i = DS3232RTC::bus().writeSRAM(_cursor, buf, size);
     _cursor += i;
     #if ARDUINO >= 100
     return i;
@@ -645,22 +784,8 @@ void DS3232SRAM::write(const uint8_t *buf, size_t size) {
  *
  */
 int DS3232SRAM::available() {
-  if (!_init) {
-    _init = true;
-    Wire.beginTransmission(DS3232_I2C_ADDRESS);
-    Wire.write(0x05);  // sends 05h - month register
-    Wire.endTransmission();
-    Wire.requestFrom(DS3232_I2C_ADDRESS, 1);
-    if (Wire.available()) {
-      uint8_t dummy = Wire.read();
-      _avail = true;
-    } else {
-      _avail = false;
-    }
-  }
-
-  if (_avail) {
-    return 0xEC - _cursor;  // How many bytes left
+  if (DS3232RTC::available()) {
+    return DS3232_SRAM_SIZE - _cursor;  // How many bytes left
   } else {
     return -1;
   }
@@ -679,16 +804,9 @@ int DS3232SRAM::read() {
  *
  */
 int DS3232SRAM::peek() {
-  if (available() > 0) {
-    Wire.beginTransmission(DS3232_I2C_ADDRESS);
-    Wire.write(0x14 + _cursor); 
-    Wire.endTransmission();  
-    Wire.requestFrom(DS3232_I2C_ADDRESS, 1);
-    if (Wire.available()) {
-      return Wire.read();
-    } else {
-      return -1;
-    }
+  uint8_t data;
+  if ((available() > 0) && (DS3232RTC::bus().readSRAM(_cursor, &data, 1) == 1)) {
+    return data;
   } else {
     return -1;
   }
@@ -705,7 +823,7 @@ void DS3232SRAM::flush() {
  *
  */
 uint8_t DS3232SRAM::seek(uint8_t pos) {
-  if (pos <= 0xEB)
+  if (pos < DS3232_SRAM_SIZE)
     _cursor = pos;
   return _cursor;
 }
@@ -23,21 +23,13 @@
 #include <Wire.h>    // http://arduino.cc/en/Reference/Wire
 #include <Stream.h>  // http://arduino.cc/en/Reference/Stream
 #include <TimeLib.h> // http://playground.arduino.cc/Code/time
+#include "DS3232Regs.h"
 
 // Based on page 11 of specs; http://www.maxim-ic.com/datasheet/index.mvp/id/4984
 #define DS3232_I2C_ADDRESS 0x68
 
-enum alarmMode_t {
-  alarmModeUnknown,       // not in spec table
-  alarmModePerSecond,     // once per second, A1 only
-  alarmModePerMinute,     // once per minute, A2 only
-  alarmModeSecondsMatch,  // when seconds match, A1 only
-  alarmModeMinutesMatch,  // when minutes [and seconds] match
-  alarmModeHoursMatch,    // when hours, minutes [and seconds] match
-  alarmModeDateMatch,     // when date (of month), hours, minutes [and seconds] match
-  alarmModeDayMatch,      // when day (of week), hours, minutes [and seconds] match
-  alarmModeOff            // set to date or day, but value is 0
-  };
+// SRAM size exposed by DS3232SRAM, DS3232 registers 14h~FFh
+#define DS3232_SRAM_SIZE 0xEC
 
 enum sqiMode_t {
   sqiModeNone, 
@@ -68,14 +60,52 @@ static const uint8_t NO_TEMPERATURE = 0x7F;
 #define temperatureCToF(C) (C * 9 / 5 + 32)
 #define temperatureFToC(F) ((F - 32) * 5 / 9)
 
+/**
+ * DS3232Bus Class
+ * Transport for the register map, shared by the DS3232 (I2C) and DS3234 (SPI)
+ */
+class DS3232Bus
+{
+  public:
+    constexpr DS3232Bus() {}
+    virtual void begin() = 0;
+    // Registers, return the number of bytes transferred
+    virtual uint8_t read(uint8_t addr, uint8_t *buf, uint8_t size) = 0;
+    virtual uint8_t write(uint8_t addr, const uint8_t *buf, uint8_t size) = 0;
+    // SRAM, addr 0 is the first byte of SRAM
+    virtual uint8_t readSRAM(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size);
+};
+
+/**
+ * DS3232Wire Class
+ * DS3232 on an I2C bus
+ */
+class DS3232Wire : public DS3232Bus
+{
+  public:
+    constexpr DS3232Wire(TwoWire &wire = Wire, uint8_t address = DS3232_I2C_ADDRESS)
+      : _wire(&wire), _address(address) {}
+    virtual void begin();
+    virtual uint8_t read(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t write(uint8_t addr, const uint8_t *buf, uint8_t size);
+  private:
+    TwoWire *_wire;
+    uint8_t _address;
+};
+
 /**
  * DS3232RTC Class
  */
 class DS3232RTC
 {
   public:
-    DS3232RTC();
+    constexpr DS3232RTC() {}
+    static void begin();
+    static void setBus(DS3232Bus &bus);
+    static DS3232Bus &bus();
     static bool available();
+    static bool reprobe();
     // Date and Time
     static time_t get();
     static void set(time_t t);
@@ -103,18 +133,50 @@ class DS3232RTC
     static void clearAlarmFlag(uint8_t alarm);
     // Temperature
     static void readTemperature(tpElements_t &tmp);
+    // Register encoding, for code doing its own bus transfers
+    static void decodeTime(const uint8_t *data, tmElements_t &tm);
+    static void encodeTime(tmElements_t &tm, uint8_t *data);
+    static bool encodeAlarm(alarmMode_t mode, tmElements_t &tm, uint8_t *data);
   private:
     static uint8_t dec2bcd(uint8_t num);
     static uint8_t bcd2dec(uint8_t num);
   protected:
-    static void _wTime(tmElements_t &tm);
-    static void _wDate(tmElements_t &tm);
+    static void _wTime(tmElements_t &tm, uint8_t *data);
+    static void _wDate(tmElements_t &tm, uint8_t *data);
     static uint8_t read1(uint8_t addr);
     static void write1(uint8_t addr, uint8_t data);
+    static DS3232Bus *_bus;
+    static bool _begun;
+    static uint8_t _probe;
 };
 
 extern DS3232RTC RTC;
 
+// Registers 07h~0Fh; alarm 1, alarm 2, Control and Status
+#define DS3232_PLAN_SIZE 9
+
+/**
+ * DS3232AlarmPlan Class
+ * Collects alarm, interrupt and flag changes and writes them in one burst
+ */
+class DS3232AlarmPlan
+{
+  public:
+    DS3232AlarmPlan();
+    bool load();
+    DS3232AlarmPlan &writeAlarm(uint8_t alarm, alarmMode_t mode, tmElements_t tm);
+    DS3232AlarmPlan &setSQIMode(sqiMode_t mode);
+    DS3232AlarmPlan &clearAlarmFlag(uint8_t alarm);
+    bool commit();
+  private:
+    void mark(uint8_t first, uint8_t last);
+    uint8_t _data[DS3232_PLAN_SIZE];
+    uint16_t _valid;  // bit per register holding a known value
+    uint16_t _dirty;  // bit per register to write
+    uint8_t _sqi;     // low 5 bits of Control
+    uint8_t _clear;   // DS3232_A1F | DS3232_A2F
+};
+
 /**
  * DS3232SRAM Class
  */
@@ -125,6 +187,9 @@ class DS3232SRAM : public Stream
     // more like EEPROMClass
     static uint8_t read(int addr);
     static void write(int addr, uint8_t data);
+    // burst access, no cursor movement
+    static uint8_t read(int addr, uint8_t *buf, uint8_t size);
+    static uint8_t write(int addr, const uint8_t *buf, uint8_t size);
 
     // from Print class
     #if ARDUINO >= 100
@@ -146,8 +211,6 @@ class DS3232SRAM : public Stream
     uint8_t tell();  // Returns the position of the current character in the stream.
 
   private:
-    bool _init;
-    bool _avail;
     uint8_t _cursor;
 };
 
@@ -0,0 +1,445 @@
+/*
+ * DS3232Timezone.cpp - local time from POSIX TZ rules on top of DS3232RTC
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "DS3232Timezone.h"
+
+#define TZ_DEFAULT_TIME 7200L  // 02:00:00
+#define TZ_MAX_RULE_HOURS 167  // rule times run to 167:59:59
+#define TZ_MAX_RULE_TIME (TZ_MAX_RULE_HOURS * 3600L + 59 * 60 + 59)
+
+static const uint8_t daysInMonth[12] PROGMEM = {
+  31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+// Used when a DST name is given without rules
+static const char usRules[] = "M3.2.0,M11.1.0";
+
+/**
+ * \brief True for a leap year (full calendar year)
+ */
+static inline bool isLeap(uint16_t year) {
+  return ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+}
+
+/**
+ * \brief Days from 1970-01-01 to January 1st of year (1970 or later)
+ */
+static uint32_t yearStart(uint16_t year) {
+  return 365UL * (year - 1970) + (year - 1969) / 4 - (year - 1901) / 100 + (year - 1601) / 400;
+}
+
+/**
+ * \brief Read up to 3 digits, NULL if there are none
+ */
+static const char *parseNum(const char *p, uint16_t &num) {
+  uint8_t i;
+
+  num = 0;
+  for (i = 0; (i < 3) && (p[i] >= '0') && (p[i] <= '9'); i++) {
+    num = num * 10 + (p[i] - '0');
+  }
+  return (i == 0) ? 0 : p + i;
+}
+
+/**
+ * \brief Skip a zone name, 3 or more letters or anything between '<' and '>'
+ */
+static const char *parseName(const char *p) {
+  uint8_t n = 0;
+
+  if (*p == '<') {
+    for (p++; (*p != '\0') && (*p != '>'); p++) n++;
+    return ((*p == '>') && (n >= 3)) ? p + 1 : 0;
+  }
+  for (; ((*p >= 'A') && (*p <= 'Z')) || ((*p >= 'a') && (*p <= 'z')); p++) n++;
+  return (n >= 3) ? p : 0;
+}
+
+/**
+ * \brief Read [+|-]hh[:mm[:ss]] as seconds, hours up to maxHours
+ */
+static const char *parseTime(const char *p, int32_t &secs, uint8_t maxHours) {
+  bool negative = false;
+  uint16_t h, m = 0, s = 0;
+
+  if ((*p == '+') || (*p == '-')) negative = (*p++ == '-');
+  if (!(p = parseNum(p, h)) || (h > maxHours)) return 0;
+  if (*p == ':') {
+    if (!(p = parseNum(p + 1, m)) || (m > 59)) return 0;
+    if (*p == ':') {
+      if (!(p = parseNum(p + 1, s)) || (s > 59)) return 0;
+    }
+  }
+  secs = h * 3600L + m * 60L + s;
+  if (negative) secs = -secs;
+  return p;
+}
+
+/**
+ * \brief Read Jn, n or Mm.w.d with an optional /time
+ */
+static const char *parseRule(const char *p, tzRule_t &rule) {
+  uint16_t m, w, d;
+
+  memset(&rule, 0, sizeof(tzRule_t));
+  if (*p == 'M') {
+    if (!(p = parseNum(p + 1, m)) || (m < 1) || (m > 12) || (*p != '.')) return 0;
+    if (!(p = parseNum(p + 1, w)) || (w < 1) || (w > 5) || (*p != '.')) return 0;
+    if (!(p = parseNum(p + 1, d)) || (d > 6)) return 0;
+    rule.Kind = 'M';
+    rule.Month = m;
+    rule.Week = w;
+    rule.Day = d;
+  } else if (*p == 'J') {
+    if (!(p = parseNum(p + 1, d)) || (d < 1) || (d > 365)) return 0;
+    rule.Kind = 'J';
+    rule.Day = d;
+  } else {
+    if (!(p = parseNum(p, d)) || (d > 365)) return 0;
+    rule.Kind = 'D';
+    rule.Day = d;
+  }
+  rule.Time = TZ_DEFAULT_TIME;
+  if (*p == '/') p = parseTime(p + 1, rule.Time, TZ_MAX_RULE_HOURS);
+  return p;
+}
+
+/**
+ * \brief The same ranges parseRule() accepts, for rules read back from SRAM
+ */
+static bool validRule(const tzRule_t &rule) {
+  if ((rule.Time < -TZ_MAX_RULE_TIME) || (rule.Time > TZ_MAX_RULE_TIME)) return false;
+  switch (rule.Kind) {
+    case 'M':
+      return (rule.Month >= 1) && (rule.Month <= 12) && (rule.Week >= 1) && (rule.Week <= 5) && (rule.Day <= 6);
+    case 'J':
+      return (rule.Day >= 1) && (rule.Day <= 365);
+    case 'D':
+      return (rule.Day <= 365);
+  }
+  return false;
+}
+
+/**
+ *
+ */
+static void put32(uint8_t *buf, uint32_t v) {
+  buf[0] = v & 0xFF;
+  buf[1] = (v >> 8) & 0xFF;
+  buf[2] = (v >> 16) & 0xFF;
+  buf[3] = (v >> 24) & 0xFF;
+}
+
+/**
+ *
+ */
+static uint32_t get32(const uint8_t *buf) {
+  return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+    ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3232Timezone Class                                                 | */
+/* +----------------------------------------------------------------------+ */
+
+/**
+ * \brief UTC until begin() or load()
+ */
+DS3232Timezone::DS3232Timezone()
+  : _std(0)
+  , _dst(0)
+  , _hasDST(false)
+  , _dstMask(0)
+  , _lo(0)
+  , _hi(0)
+  , _offset(0)
+  , _inDST(false)
+{
+  memset(&_start, 0, sizeof(tzRule_t));
+  memset(&_end, 0, sizeof(tzRule_t));
+  memset(_at, 0, sizeof(_at));
+}
+
+/**
+ * \brief Compile a POSIX TZ string (see DS3232Timezone.h)
+ * The zone in use is kept when tz does not parse.
+ */
+bool DS3232Timezone::begin(const char *tz) {
+  int32_t std, dst;
+  tzRule_t start, end;
+  bool hasDST = false;
+  const char *p;
+
+  if (!(p = parseName(tz)) || !(p = parseTime(p, std, 24))) return false;
+  std = -std;  // POSIX counts hours west
+  dst = std;
+  if (*p != '\0') {
+    if (!(p = parseName(p))) return false;
+    dst = std + SECS_PER_HOUR;
+    if ((*p != ',') && (*p != '\0')) {
+      if (!(p = parseTime(p, dst, 24))) return false;
+      dst = -dst;
+    }
+    if (*p == '\0') {
+      p = usRules;
+    } else if (*p++ != ',') {
+      return false;
+    }
+    if (!(p = parseRule(p, start)) || (*p++ != ',')) return false;
+    if (!(p = parseRule(p, end)) || (*p != '\0')) return false;
+    hasDST = true;
+  }
+
+  _std = std;
+  _dst = dst;
+  _hasDST = hasDST;
+  if (hasDST) {
+    _start = start;
+    _end = end;
+  }
+  memset(_at, 0, sizeof(_at));  // refilled by the next conversion
+  _dstMask = 0;
+  _lo = 0;
+  _hi = 0;
+  _offset = std;
+  _inDST = false;
+  return true;
+}
+
+/**
+ * \brief True when utc needs no lookup()
+ * A zone without DST has one interval with no end, which no time_t value
+ * can mark on a 32 bit signed time_t, so it is checked for apart.
+ */
+inline bool DS3232Timezone::cached(time_t utc) {
+  return !_hasDST || ((utc >= _lo) && (utc < _hi));
+}
+
+/**
+ *
+ */
+time_t DS3232Timezone::get() {
+  return toLocal(RTC.get());
+}
+
+/**
+ * \brief UTC to local time
+ */
+time_t DS3232Timezone::toLocal(time_t utc) {
+  if (!cached(utc)) lookup(utc);
+  return utc + _offset;
+}
+
+/**
+ * \brief Local time to UTC
+ * A time skipped by a DST start moves forward, a repeated one gives the later instant.
+ */
+time_t DS3232Timezone::toUTC(time_t local) {
+  int32_t off = offset(local - _std);
+  time_t utc = local - off;
+  int32_t check = offset(utc);
+
+  if (check != off) utc = local - check;
+  return utc;
+}
+
+/**
+ * \brief Seconds east of UTC in effect at utc
+ */
+int32_t DS3232Timezone::offset(time_t utc) {
+  if (!cached(utc)) lookup(utc);
+  return _offset;
+}
+
+/**
+ *
+ */
+bool DS3232Timezone::isDST(time_t utc) {
+  if (!cached(utc)) lookup(utc);
+  return _inDST;
+}
+
+/**
+ * \brief DS3232RTC::writeAlarm() with the alarm given in local time
+ * The RTC matches in UTC, so an alarm repeating over a DST change needs writing again.
+ */
+void DS3232Timezone::writeAlarm(uint8_t alarm, alarmMode_t mode, time_t local) {
+  tmElements_t tm;
+
+  breakTime(toUTC(local), tm);
+  RTC.writeAlarm(alarm, mode, tm);
+}
+
+/**
+ * \brief Keep the rules and the cached transitions in SRAM from offset start
+ */
+bool DS3232Timezone::save(uint8_t start) {
+  uint8_t buf[DS3232TZ_SAVE_SIZE];
+  const tzRule_t *rules[2] = { &_start, &_end };
+  uint8_t *p = buf;
+  uint8_t i, sum = 0;
+
+  if (start > DS3232_SRAM_SIZE - DS3232TZ_SAVE_SIZE) return false;
+  *p++ = DS3232TZ_MAGIC;
+  *p++ = _hasDST ? 1 : 0;
+  put32(p, (uint32_t)_std);
+  put32(p + 4, (uint32_t)_dst);
+  p += 8;
+  for (i = 0; i < 2; i++) {
+    *p++ = rules[i]->Kind;
+    *p++ = rules[i]->Month;
+    *p++ = rules[i]->Week;
+    *p++ = rules[i]->Day & 0xFF;
+    *p++ = rules[i]->Day >> 8;
+    put32(p, (uint32_t)rules[i]->Time);
+    p += 4;
+  }
+  for (i = 0; i < DS3232TZ_CACHE; i++) {
+    put32(p, (uint32_t)_at[i]);
+    p += 4;
+  }
+  *p++ = _dstMask;
+  for (i = 0; i < DS3232TZ_SAVE_SIZE - 1; i++) sum += buf[i];
+  *p = sum;
+  return (SRAM.write(start, buf, DS3232TZ_SAVE_SIZE) == DS3232TZ_SAVE_SIZE);
+}
+
+/**
+ * \brief Restore a zone written by save(), in one SRAM burst
+ */
+bool DS3232Timezone::load(uint8_t start) {
+  uint8_t buf[DS3232TZ_SAVE_SIZE];
+  tzRule_t rules[2];
+  const uint8_t *p = buf;
+  uint8_t i, sum = 0;
+  int32_t std, dst;
+  bool hasDST;
+
+  if (start > DS3232_SRAM_SIZE - DS3232TZ_SAVE_SIZE) return false;
+  if (SRAM.read(start, buf, DS3232TZ_SAVE_SIZE) != DS3232TZ_SAVE_SIZE) return false;
+  for (i = 0; i < DS3232TZ_SAVE_SIZE - 1; i++) sum += buf[i];
+  if ((buf[0] != DS3232TZ_MAGIC) || (buf[DS3232TZ_SAVE_SIZE - 1] != sum)) return false;
+
+  // A block that sums right may still come from another version or a
+  // stray write; the rules index month tables, so check them as begin() would
+  p++;
+  hasDST = (*p++ != 0);
+  std = (int32_t)get32(p);
+  dst = (int32_t)get32(p + 4);
+  p += 8;
+  for (i = 0; i < 2; i++) {
+    rules[i].Kind = *p++;
+    rules[i].Month = *p++;
+    rules[i].Week = *p++;
+    rules[i].Day = p[0] | (p[1] << 8);
+    p += 2;
+    rules[i].Time = (int32_t)get32(p);
+    p += 4;
+    if (hasDST && !validRule(rules[i])) return false;
+  }
+
+  _hasDST = hasDST;
+  _std = std;
+  _dst = dst;
+  _start = rules[0];
+  _end = rules[1];
+  for (i = 0; i < DS3232TZ_CACHE; i++) {
+    _at[i] = (time_t)get32(p);
+    p += 4;
+  }
+  _dstMask = *p;
+  _lo = 0;
+  _hi = 0;
+  _offset = _std;
+  _inDST = false;
+  return true;
+}
+
+/**
+ * \brief Find the interval holding utc, refilling the transitions when it is outside them
+ * Only called for zones with DST, see cached().
+ */
+void DS3232Timezone::lookup(time_t utc) {
+  uint8_t i;
+
+  if ((utc < _at[0]) || (utc >= _at[DS3232TZ_CACHE - 1])) fill(utc);
+  if ((utc < _at[0]) || (utc >= _at[DS3232TZ_CACHE - 1])) {
+    // before the first transition of 1970, not cached
+    _lo = 0;
+    _hi = 0;
+    _offset = _std;
+    _inDST = false;
+    return;
+  }
+  for (i = 1; utc >= _at[i]; i++);
+  _lo = _at[i - 1];
+  _hi = _at[i];
+  _inDST = ((_dstMask & (1 << (i - 1))) != 0);
+  _offset = _inDST ? _dst : _std;
+}
+
+/**
+ * \brief Compute the transitions of the years before, of and after utc
+ */
+void DS3232Timezone::fill(time_t utc) {
+  tmElements_t tm;
+  uint16_t year;
+  time_t on, off;
+  uint8_t i, n = 0;
+
+  breakTime(utc, tm);
+  year = tmYearToCalendar(tm.Year);
+  if (year > 1970) year--;
+  _dstMask = 0;
+  for (i = 0; i < DS3232TZ_CACHE / 2; i++, year++) {
+    on = transition(year, _start, _std);
+    off = transition(year, _end, _dst);
+    if (on < off) {
+      _dstMask |= (1 << n);
+      _at[n++] = on;
+      _at[n++] = off;
+    } else {
+      _at[n++] = off;
+      _dstMask |= (1 << n);
+      _at[n++] = on;
+    }
+  }
+}
+
+/**
+ * \brief When rule falls in year, as UTC; before is the offset in effect up to it
+ */
+time_t DS3232Timezone::transition(uint16_t year, const tzRule_t &rule, int32_t before) {
+  uint32_t days = yearStart(year);
+  bool leap = isLeap(year);
+  uint16_t doy = 0;
+  uint8_t i, len, first;
+
+  switch (rule.Kind) {
+    case 'J':
+      doy = rule.Day - 1;
+      if (leap && (rule.Day >= 60)) doy++;
+      break;
+    case 'D':
+      doy = rule.Day;
+      break;
+    case 'M':
+      for (i = 0; i < rule.Month - 1; i++) doy += pgm_read_byte(&daysInMonth[i]);
+      if (leap && (rule.Month > 2)) doy++;
+      len = pgm_read_byte(&daysInMonth[rule.Month - 1]);
+      if (leap && (rule.Month == 2)) len++;
+      first = (days + doy + 4) % 7;  // 1970-01-01 was a Thursday
+      i = (rule.Day + 7 - first) % 7 + 7 * (rule.Week - 1);
+      if (i >= len) i -= 7;
+      doy += i;
+      break;
+  }
+  return (time_t)((days + doy) * SECS_PER_DAY) + (rule.Time - before);
+}
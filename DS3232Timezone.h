@@ -0,0 +1,94 @@
+/*
+ * DS3232Timezone.h - local time from POSIX TZ rules on top of DS3232RTC
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#ifndef DS3232Timezone_h
+#define DS3232Timezone_h
+
+#include <stdint.h>
+#include <TimeLib.h> // http://playground.arduino.cc/Code/time
+#include "DS3232RTC.h"
+
+/*
+  The RTC keeps UTC.  begin() takes a POSIX TZ string, e.g.
+
+    "UTC0"
+    "CET-1CEST,M3.5.0,M10.5.0/3"
+    "AEST-10AEDT,M10.1.0,M4.1.0/3"
+    "<+0330>-3:30"
+
+  Offsets are hours west of UTC as POSIX has them.  A rule is Jn (1~365,
+  Feb 29 never counted), n (0~365) or Mm.w.d (week 5 = last), with an
+  optional /time (default 02:00:00).  A DST name without rules uses the
+  US rules, M3.2.0,M11.1.0.
+
+  The transitions of the years before, of and after the last conversion
+  are kept in RAM, and the interval holding the last conversion is kept
+  apart from them, so toLocal() is a single range check until it crosses
+  a transition.
+
+  save() layout, starting at the SRAM offset given:
+
+    +0  magic (DS3232TZ_MAGIC)
+    +1  1 if the zone has DST
+    +2  standard offset, seconds east of UTC, int32_t little endian
+    +6  DST offset
+    +10 start and end rules, 9 bytes each (kind, month, week, day, time)
+    +28 cached transitions, time_t little endian (4 bytes each)
+    +52 bit per transition, set when DST starts there
+    +53 sum of bytes 0~52
+*/
+#define DS3232TZ_MAGIC      0xD7
+#define DS3232TZ_CACHE      6
+#define DS3232TZ_SAVE_SIZE  54
+
+typedef struct {
+  uint8_t Kind;    // 'J', 'D' (zero based day of year) or 'M'
+  uint8_t Month;   // 1~12, for 'M'
+  uint8_t Week;    // 1~5, for 'M'
+  uint16_t Day;    // day of week (0 = Sunday) for 'M', day of year otherwise
+  int32_t Time;    // seconds after local midnight
+} tzRule_t;
+
+/**
+ * DS3232Timezone Class
+ */
+class DS3232Timezone
+{
+  public:
+    DS3232Timezone();
+    bool begin(const char *tz);
+    // Conversion
+    time_t get();  // RTC.get() as local time
+    time_t toLocal(time_t utc);
+    time_t toUTC(time_t local);
+    int32_t offset(time_t utc);  // seconds east of UTC
+    bool isDST(time_t utc);
+    // Alarms, set in local time
+    void writeAlarm(uint8_t alarm, alarmMode_t mode, time_t local);
+    // Persistence in SRAM
+    bool save(uint8_t start);
+    bool load(uint8_t start);
+  private:
+    bool cached(time_t utc);
+    void lookup(time_t utc);
+    void fill(time_t utc);
+    static time_t transition(uint16_t year, const tzRule_t &rule, int32_t before);
+    int32_t _std;
+    int32_t _dst;
+    bool _hasDST;
+    tzRule_t _start;
+    tzRule_t _end;
+    time_t _at[DS3232TZ_CACHE];
+    uint8_t _dstMask;
+    // interval of the last conversion
+    time_t _lo;
+    time_t _hi;
+    int32_t _offset;
+    bool _inDST;
+};
+
+#endif
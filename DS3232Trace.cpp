@@ -0,0 +1,286 @@
+/*
+ * DS3232Trace.cpp - record and replay the register traffic of DS3232RTC and DS3232SRAM
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <Arduino.h>
+#include "DS3232Trace.h"
+
+/**
+ * \brief Microseconds as a saturated uint16_t
+ */
+static uint16_t sat16(unsigned long us) {
+  return (us > 0xFFFF) ? 0xFFFF : (uint16_t)us;
+}
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3232Trace Class                                                    | */
+/* +----------------------------------------------------------------------+ */
+
+/**
+ * \brief Record the traffic of bus into size bytes at ring
+ */
+DS3232Trace::DS3232Trace(DS3232Bus &bus, uint8_t *ring, uint16_t size)
+  : _bus(&bus)
+  , _ring(ring)
+  , _size(size)
+  , _head(0)
+  , _used(0)
+  , _dropped(0)
+  , _last(0)
+{
+}
+
+/**
+ *
+ */
+void DS3232Trace::begin() {
+  _bus->begin();
+}
+
+/**
+ *
+ */
+uint8_t DS3232Trace::read(uint8_t addr, uint8_t *buf, uint8_t size) {
+  unsigned long start = micros();
+  uint8_t n = _bus->read(addr, buf, size);
+  record(0, addr, buf, n, start);
+  return n;
+}
+
+/**
+ *
+ */
+uint8_t DS3232Trace::write(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  unsigned long start = micros();
+  uint8_t n = _bus->write(addr, buf, size);
+  record(DS3232TRACE_WRITE, addr, buf, n, start);
+  return n;
+}
+
+/**
+ *
+ */
+uint8_t DS3232Trace::readSRAM(uint8_t addr, uint8_t *buf, uint8_t size) {
+  unsigned long start = micros();
+  uint8_t n = _bus->readSRAM(addr, buf, size);
+  record(DS3232TRACE_SRAM, addr, buf, n, start);
+  return n;
+}
+
+/**
+ *
+ */
+uint8_t DS3232Trace::writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  unsigned long start = micros();
+  uint8_t n = _bus->writeSRAM(addr, buf, size);
+  record(DS3232TRACE_WRITE | DS3232TRACE_SRAM, addr, buf, n, start);
+  return n;
+}
+
+/**
+ * \brief Empty the ring
+ */
+void DS3232Trace::clear() {
+  _head = 0;
+  _used = 0;
+  _dropped = 0;
+}
+
+/**
+ * \brief Number of bytes of trace held in the ring
+ */
+uint16_t DS3232Trace::used() {
+  return _used;
+}
+
+/**
+ * \brief Number of records dropped to make room (or too large to keep)
+ */
+uint16_t DS3232Trace::dropped() {
+  return _dropped;
+}
+
+/**
+ * \brief Copy the trace from offset (0 = oldest record) into buf, returns bytes copied
+ */
+uint16_t DS3232Trace::copy(uint16_t offset, uint8_t *buf, uint16_t size) {
+  uint16_t i;
+  uint16_t pos;
+
+  if (offset >= _used) return 0;
+  if (size > _used - offset) size = _used - offset;
+  pos = (_head + _size - _used + offset) % _size;
+  for (i = 0; i < size; i++) {
+    buf[i] = _ring[pos];
+    if (++pos == _size) pos = 0;
+  }
+  return size;
+}
+
+/**
+ *
+ */
+void DS3232Trace::record(uint8_t flags, uint8_t addr, const uint8_t *buf, uint8_t n, unsigned long start) {
+  uint16_t total = DS3232TRACE_HEADER + n;
+  uint16_t delta = sat16(start - _last);
+  uint16_t duration = sat16(micros() - start);
+  uint8_t i;
+
+  _last = start;
+  if (total > _size) {
+    _dropped++;
+    return;
+  }
+  while (_size - _used < total) {
+    // evict the oldest record, its length is at offset 2
+    uint16_t tail = (_head + _size - _used) % _size;
+    _used -= DS3232TRACE_HEADER + _ring[(tail + 2) % _size];
+    _dropped++;
+  }
+  put(flags);
+  put(addr);
+  put(n);
+  put(delta & 0xFF);
+  put(delta >> 8);
+  put(duration & 0xFF);
+  put(duration >> 8);
+  for (i = 0; i < n; i++) put(buf[i]);
+}
+
+/**
+ *
+ */
+void DS3232Trace::put(uint8_t b) {
+  _ring[_head] = b;
+  if (++_head == _size) _head = 0;
+  _used++;
+}
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3232Replay Class                                                   | */
+/* +----------------------------------------------------------------------+ */
+
+/**
+ * \brief Replay size bytes of trace, as exported by DS3232Trace::copy()
+ */
+DS3232Replay::DS3232Replay(const uint8_t *trace, uint16_t size)
+  : _trace(trace)
+  , _size(size)
+{
+  rewind();
+}
+
+/**
+ *
+ */
+void DS3232Replay::begin() {
+}
+
+/**
+ *
+ */
+uint8_t DS3232Replay::read(uint8_t addr, uint8_t *buf, uint8_t size) {
+  return replay(0, addr, buf, 0, size);
+}
+
+/**
+ *
+ */
+uint8_t DS3232Replay::write(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  return replay(DS3232TRACE_WRITE, addr, 0, buf, size);
+}
+
+/**
+ *
+ */
+uint8_t DS3232Replay::readSRAM(uint8_t addr, uint8_t *buf, uint8_t size) {
+  return replay(DS3232TRACE_SRAM, addr, buf, 0, size);
+}
+
+/**
+ *
+ */
+uint8_t DS3232Replay::writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  return replay(DS3232TRACE_WRITE | DS3232TRACE_SRAM, addr, 0, buf, size);
+}
+
+/**
+ * \brief Start again from the first record and reset the statistics
+ */
+void DS3232Replay::rewind() {
+  _pos = 0;
+  _transactions = 0;
+  _mismatches = 0;
+  _bytes = 0;
+  _busTime = 0;
+}
+
+/**
+ * \brief True once every record has been replayed
+ */
+bool DS3232Replay::done() {
+  return (_pos >= _size);
+}
+
+/**
+ *
+ */
+uint16_t DS3232Replay::transactions() {
+  return _transactions;
+}
+
+/**
+ * \brief Calls that did not match the next record, or wrote different data
+ */
+uint16_t DS3232Replay::mismatches() {
+  return _mismatches;
+}
+
+/**
+ *
+ */
+uint32_t DS3232Replay::bytes() {
+  return _bytes;
+}
+
+/**
+ *
+ */
+uint32_t DS3232Replay::busTime() {
+  return _busTime;
+}
+
+/**
+ * \brief Match a call against the next record
+ * A call that does not match fails (returns 0) and leaves the record in place.
+ */
+uint8_t DS3232Replay::replay(uint8_t flags, uint8_t addr, uint8_t *rbuf, const uint8_t *wbuf, uint8_t size) {
+  const uint8_t *rec = _trace + _pos;
+  uint8_t n;
+
+  if (_pos + DS3232TRACE_HEADER > _size) {
+    _mismatches++;
+    return 0;
+  }
+  n = rec[2];
+  if ((rec[0] != flags) || (rec[1] != addr) || (n > size) ||
+      (_pos + DS3232TRACE_HEADER + n > _size)) {
+    _mismatches++;
+    return 0;
+  }
+  if (wbuf) {
+    if (memcmp(wbuf, rec + DS3232TRACE_HEADER, n) != 0) _mismatches++;
+  } else {
+    memcpy(rbuf, rec + DS3232TRACE_HEADER, n);
+  }
+  _pos += DS3232TRACE_HEADER + n;
+  _transactions++;
+  _bytes += n;
+  _busTime += (uint32_t)rec[5] | ((uint32_t)rec[6] << 8);
+  return n;
+}
@@ -0,0 +1,95 @@
+/*
+ * DS3232Trace.h - record and replay the register traffic of DS3232RTC and DS3232SRAM
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#ifndef DS3232Trace_h
+#define DS3232Trace_h
+
+#include <stdint.h>
+#include "DS3232RTC.h"
+
+/*
+  Trace record, one per DS3232Bus call:
+
+    +0  flags, DS3232TRACE_WRITE | DS3232TRACE_SRAM
+    +1  register (or SRAM) address
+    +2  number of bytes transferred, n
+    +3  microseconds since the previous record, uint16_t little endian
+    +5  microseconds spent in the call, uint16_t little endian
+    +7  n data bytes
+
+  Times saturate at 0xFFFF.  When the ring is full the oldest records are
+  dropped, so an export always starts on a record boundary.
+
+  tests/replay.cpp replays the output of the TestRTC TRACE command on the
+  host, against DS3232Replay and the simulated DS3232.
+*/
+#define DS3232TRACE_WRITE   0x80
+#define DS3232TRACE_SRAM    0x40
+#define DS3232TRACE_HEADER  7
+
+/**
+ * DS3232Trace Class
+ * Wraps another bus and records each transaction into a caller supplied ring
+ */
+class DS3232Trace : public DS3232Bus
+{
+  public:
+    DS3232Trace(DS3232Bus &bus, uint8_t *ring, uint16_t size);
+    virtual void begin();
+    virtual uint8_t read(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t write(uint8_t addr, const uint8_t *buf, uint8_t size);
+    virtual uint8_t readSRAM(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size);
+    // Export
+    void clear();
+    uint16_t used();
+    uint16_t dropped();
+    uint16_t copy(uint16_t offset, uint8_t *buf, uint16_t size);
+  private:
+    void record(uint8_t flags, uint8_t addr, const uint8_t *buf, uint8_t n, unsigned long start);
+    void put(uint8_t b);
+    DS3232Bus *_bus;
+    uint8_t *_ring;
+    uint16_t _size;
+    uint16_t _head;
+    uint16_t _used;
+    uint16_t _dropped;
+    unsigned long _last;
+};
+
+/**
+ * DS3232Replay Class
+ * Answers bus calls from a recorded trace, e.g. with RTC.setBus() on a host build
+ */
+class DS3232Replay : public DS3232Bus
+{
+  public:
+    DS3232Replay(const uint8_t *trace, uint16_t size);
+    virtual void begin();
+    virtual uint8_t read(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t write(uint8_t addr, const uint8_t *buf, uint8_t size);
+    virtual uint8_t readSRAM(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size);
+    void rewind();
+    bool done();
+    // Statistics of the replayed traffic
+    uint16_t transactions();
+    uint16_t mismatches();
+    uint32_t bytes();
+    uint32_t busTime();  // recorded microseconds
+  private:
+    uint8_t replay(uint8_t flags, uint8_t addr, uint8_t *rbuf, const uint8_t *wbuf, uint8_t size);
+    const uint8_t *_trace;
+    uint16_t _size;
+    uint16_t _pos;
+    uint16_t _transactions;
+    uint16_t _mismatches;
+    uint32_t _bytes;
+    uint32_t _busTime;
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * DS3234SPI.cpp - SPI transport for the DS3234, register compatible with the DS3232
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#include <stdint.h>
+#include <SPI.h>
+#include "DS3234SPI.h"
+
+/* +----------------------------------------------------------------------+ */
+/* | DS3234SPI Class                                                      | */
+/* +----------------------------------------------------------------------+ */
+
+/**
+ *
+ */
+void DS3234SPI::begin() {
+  pinMode(_cs, OUTPUT);
+  digitalWrite(_cs, HIGH);
+  _spi->begin();
+  probe();
+}
+
+/**
+ * \brief Burst read from register addr, the address auto-increments
+ */
+uint8_t DS3234SPI::read(uint8_t addr, uint8_t *buf, uint8_t size) {
+  uint8_t i;
+  if (!present()) return 0;
+  select();
+  _spi->transfer(addr & ~DS3234_WRITE);
+  for (i = 0; i < size; i++) buf[i] = _spi->transfer(0x00);
+  deselect();
+  return size;
+}
+
+/**
+ * \brief Burst write from register addr, the address auto-increments
+ */
+uint8_t DS3234SPI::write(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  uint8_t i;
+  if (!present()) return 0;
+  select();
+  _spi->transfer(addr | DS3234_WRITE);
+  for (i = 0; i < size; i++) _spi->transfer(buf[i]);
+  deselect();
+  return size;
+}
+
+/**
+ * \brief Read SRAM through the address (18h) and data (19h) registers
+ * The SRAM address auto-increments after each access to the data register,
+ * so the data is one burst on 19h.
+ */
+uint8_t DS3234SPI::readSRAM(uint8_t addr, uint8_t *buf, uint8_t size) {
+  uint8_t i;
+  if (!present()) return 0;
+  write(DS3234_SRAM_ADDR, &addr, 1);
+  select();
+  _spi->transfer(DS3234_SRAM_DATA);
+  for (i = 0; i < size; i++) buf[i] = _spi->transfer(0x00);
+  deselect();
+  return size;
+}
+
+/**
+ * \brief Write SRAM through the address (18h) and data (19h) registers
+ */
+uint8_t DS3234SPI::writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size) {
+  uint8_t i;
+  if (!present()) return 0;
+  write(DS3234_SRAM_ADDR, &addr, 1);
+  select();
+  _spi->transfer(DS3234_SRAM_DATA | DS3234_WRITE);
+  for (i = 0; i < size; i++) _spi->transfer(buf[i]);
+  deselect();
+  return size;
+}
+
+/**
+ * \brief True once probe() has found the chip, trying again until then
+ */
+bool DS3234SPI::present() {
+  return _present || probe();
+}
+
+/**
+ * \brief Write two patterns to the SRAM address register (18h) and read them back
+ * A missing chip leaves MISO stuck high or low, which fails one of them.
+ */
+bool DS3234SPI::probe() {
+  static const uint8_t patterns[2] = { 0x55, 0xAA };
+  uint8_t i, back;
+
+  _present = false;
+  for (i = 0; i < 2; i++) {
+    select();
+    _spi->transfer(DS3234_SRAM_ADDR | DS3234_WRITE);
+    _spi->transfer(patterns[i]);
+    deselect();
+    select();
+    _spi->transfer(DS3234_SRAM_ADDR);
+    back = _spi->transfer(0x00);
+    deselect();
+    if (back != patterns[i]) return false;
+  }
+  _present = true;
+  return true;
+}
+
+/**
+ *
+ */
+void DS3234SPI::select() {
+  _spi->beginTransaction(SPISettings(DS3234_SPI_CLOCK, MSBFIRST, SPI_MODE1));
+  digitalWrite(_cs, LOW);
+}
+
+/**
+ *
+ */
+void DS3234SPI::deselect() {
+  digitalWrite(_cs, HIGH);
+  _spi->endTransaction();
+}
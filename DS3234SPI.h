@@ -0,0 +1,51 @@
+/*
+ * DS3234SPI.h - SPI transport for the DS3234, register compatible with the DS3232
+ * This library is intended to be used with Arduino Time.h library functions; http://playground.arduino.cc/Code/Time
+
+ (See DS3232RTC.h for notes & license)
+ */
+
+#ifndef DS3234SPI_h
+#define DS3234SPI_h
+
+#include <stdint.h>
+#include <SPI.h>     // http://arduino.cc/en/Reference/SPI
+#include "DS3232RTC.h"
+
+// Based on page 12 of specs; http://datasheets.maximintegrated.com/en/ds/DS3234.pdf
+#define DS3234_WRITE        0x80  // OR'ed into the register address for writes
+#define DS3234_SRAM_ADDR    0x18
+#define DS3234_SRAM_DATA    0x19
+#define DS3234_SPI_CLOCK    4000000
+
+/**
+ * DS3234SPI Class
+ * Use with RTC.setBus(); the DS3234 has 256 bytes of SRAM but DS3232SRAM
+ * keeps to the first DS3232_SRAM_SIZE so layouts stay portable.
+ * SPI has no acknowledge, so begin() looks for the chip by writing the SRAM
+ * address register (18h) and reading it back.  Until that works every
+ * transfer returns 0, and tries the probe again, so RTC.available() and
+ * RTC.reprobe() see a missing DS3234 as they would on Wire.  A chip taken
+ * away after it was found goes unnoticed until begin() runs again.
+ */
+class DS3234SPI : public DS3232Bus
+{
+  public:
+    constexpr DS3234SPI(uint8_t csPin, SPIClass &spi = SPI)
+      : _spi(&spi), _cs(csPin), _present(false) {}
+    virtual void begin();
+    virtual uint8_t read(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t write(uint8_t addr, const uint8_t *buf, uint8_t size);
+    virtual uint8_t readSRAM(uint8_t addr, uint8_t *buf, uint8_t size);
+    virtual uint8_t writeSRAM(uint8_t addr, const uint8_t *buf, uint8_t size);
+  private:
+    bool present();
+    bool probe();
+    void select();
+    void deselect();
+    SPIClass *_spi;
+    uint8_t _cs;
+    bool _present;
+};
+
+#endif
@@ -27,7 +27,7 @@ This example demonstrates how to read and write time, date, and other
 information from the DS3232 realtime clock chip.  The application is
 controlled from the Serial Monitor in the Arduino IDE using a simple
 command and response system.  Configure the Serial Monitor to use
-"Newline" line endings.  Type "HELP" to get a list of commands.
+115200 baud and "Newline" line endings.  Type "HELP" to get a list of commands.
 
 How to wire the Freetronics RTC module
 --------------------------------------
@@ -40,6 +40,39 @@ Freetronics RTC -> Freetronics Eleven
     32K         ->     not connected
     SQI         ->     D2 (this is INT0 on UNO boards)
     RST         ->     not connected
+
+Binary protocol
+---------------
+Host tools can skip the text commands and send a batch of operations in
+one frame; the sketch runs them all and answers with one frame.
+
+    frame    = A5h, length (2 bytes, LSB first), payload, CRC
+    CRC      = CRC-8/Maxim (poly 31h reflected, init 0) of length and payload
+
+Request payload is a list of operations (at most FRAME_MAX bytes):
+
+    01h addr count          read count registers from addr (burst)
+    02h addr count data...  write count registers from addr
+    03h addr count          read count bytes of SRAM from addr
+    04h addr count data...  write count bytes of SRAM from addr
+    05h                     read the time as time_t (4 bytes, LSB first)
+    06h t0 t1 t2 t3         set the time from time_t (LSB first)
+
+Response payload has, for each operation in order, a status byte (00h ok,
+01h bus error, 02h time the RTC can't hold, i.e. before 2000) followed by
+the data read, zero filled on error.  Reads are streamed in chunks of up
+to FRAME_CHUNK (16) bytes and each chunk has its own status byte, so a
+read of count bytes answers (count + 15) / 16 status bytes, or one if
+count is 0.  A frame with a bad CRC or a malformed operation is answered
+with the payload FFh.  Example, a full readout of registers 00h~13h and
+all of SRAM:
+
+    A5 06 00 01 00 14 03 00 EC crc
+
+The answer to it is 277 bytes, about 24 ms at 115200 baud.
+
+tests/frame.h has a host side encoder and decoder for these frames and
+tests/rtcframe.cpp sends them over a serial port.
 */
 
 #include <Wire.h>  
@@ -47,6 +80,8 @@ Freetronics RTC -> Freetronics Eleven
 #include <avr/pgmspace.h>
 #include <string.h>
 #include "DS3232RTC.h"  // DS3232 library that returns time as a time_t
+#include "DS3232Format.h"  // ISO 8601 timestamps and alarm descriptors
+#include "DS3232Trace.h"  // Records the register traffic for replay
 
 char buffer[64];
 size_t buflen;
@@ -55,6 +90,33 @@ int led = 13; // The LED that will flash during the complete program
 bool led_on = false; // Initial state of the LED
 bool int_0 = false; // Initial state of the interrupt flag inside this program
 
+// Binary protocol state, see the notes at the top
+#define FRAME_SYNC      0xA5
+#define FRAME_MAX       64
+#define FRAME_TIMEOUT   250   // ms
+#define FRAME_REJECT    0xFF
+#define FRAME_CHUNK     16    // bytes per read chunk and status byte
+#define STATUS_OK       0x00
+#define STATUS_BUS      0x01
+#define STATUS_RANGE    0x02
+#define RTC_FIRST_TIME  946684800UL  // 2000-01-01 00:00:00, the RTC holds 2000~2199
+#define OP_READ_REGS    0x01
+#define OP_WRITE_REGS   0x02
+#define OP_READ_SRAM    0x03
+#define OP_WRITE_SRAM   0x04
+#define OP_GET_TIME     0x05
+#define OP_SET_TIME     0x06
+uint8_t frame[FRAME_MAX + 3]; // length, payload and CRC
+uint16_t framepos;
+uint16_t framelen;
+unsigned long frameStart;
+bool inFrame = false;
+uint8_t txcrc;
+
+DS3232Wire wireBus; // The RTC on the default Wire bus
+uint8_t traceRing[128];
+DS3232Trace trace(wireBus, traceRing, sizeof(traceRing)); // Used by "TRACE ON"
+
 const char *days[] = {
     "Sun, ", "Mon, ", "Tue, ", "Wed, ", "Thu, ", "Fri, ", "Sat, "
 };
@@ -85,13 +147,15 @@ inline uint8_t monthLength(const tmElements_t *date)
 }
 
 void setup() {
-    Serial.begin(9600);
+    Serial.begin(115200);
     buflen = 0;
     pinMode(led, OUTPUT); // So we can power the LED
 	pinMode(INTERRUPT_PIN, INPUT_PULLUP); //internal pullup on the Arduino ensures that we can detect the LOW from the SQW/INT pin of the RTC
 
     cmdHelp(0);
 
+    RTC.setBus(wireBus);
+    RTC.begin();  // optional, the first RTC or SRAM call starts the bus
     RTC.set33kHzOutput(false);
 
     // Wire SQI pin to pin 2 on Uno, Ethernet & Mega; pin 3 on Leonardo
@@ -104,11 +168,20 @@ void setup() {
 void loop() {
     blink();
     if (int_0) showTrigger(); // When an interrupt/alarm is trigger int_0 is true.
+    if (inFrame && (millis() - frameStart) > FRAME_TIMEOUT)
+        inFrame = false;  // Give up on a partial frame.
 
     if (Serial.available()) {
         // Process serial input for commands from the host.
         int ch = Serial.read();
-        if (ch == 0x0A || ch == 0x0D) {
+        if (inFrame) {
+            frameByte(ch);
+        } else if (ch == FRAME_SYNC && buflen == 0) {
+            // Start of a binary frame.
+            inFrame = true;
+            framepos = 0;
+            frameStart = millis();
+        } else if (ch == 0x0A || ch == 0x0D) {
             // End of the current command.  Blank lines are ignored.
             if (buflen > 0) {
                 buffer[buflen] = '\0';
@@ -230,13 +303,32 @@ void cmdTime(const char *args)
     }
 
     // Read the current time.
+    char iso[DS3232_ISO8601_LEN + 1];
     RTC.read(tm);
-    printDec2(tm.Hour);
-    Serial.print(':');
-    printDec2(tm.Minute);
-    Serial.print(':');
-    printDec2(tm.Second);
-    Serial.println();
+    formatISO8601(iso, tm);
+    Serial.println(iso + DS3232_ISO8601_TIME);
+}
+
+// "ISO" command.
+void cmdIso(const char *args)
+{
+    tmElements_t tm;
+    char iso[DS3232_ISO8601_LEN + 1];
+
+    if (*args != '\0') {
+        // Set the current date and time.
+        if (!parseISO8601(args, tm)) {
+            Serial.println("Invalid format; use YYYY-MM-DDTHH:MM:SS, year 2000 to 2199");
+            return;
+        }
+        RTC.write(tm);
+        Serial.print("Date and time have been set to: ");
+    }
+
+    // Read the current date and time.
+    RTC.read(tm);
+    formatISO8601(iso, tm);
+    Serial.println(iso);
 }
 
 // "DATE" command.
@@ -366,6 +458,7 @@ void cmdAlarms(const char *args)
 }
 
 const char s_OFF[] PROGMEM = "OFF";
+const char s_ON[] PROGMEM = "ON";
 
 // "ALARM" command.
 void cmdAlarm(const char *args)
@@ -476,13 +569,11 @@ void cmdRegisters(const char *)
 {
     static const char binchars[] = "01";
     byte value;
-    Wire.beginTransmission(DS3232_I2C_ADDRESS);
-    Wire.write(0x0E);  // sends 0Eh - Control register
-    Wire.endTransmission();
-    Wire.requestFrom(DS3232_I2C_ADDRESS, 2);
+    byte regs[2];
+    RTC.bus().read(0x0E, regs, 2);  // 0Eh - Control register
     for (byte i = 0; i < 2; i++) {
       if (i) { Serial.write("Stat: "); } else { Serial.write("Ctrl: "); }
-        value = Wire.read();
+        value = regs[i];
         Serial.print(binchars[(value >> 7) & 0x01]);
         Serial.print(binchars[(value >> 6) & 0x01]);
         Serial.print(binchars[(value >> 5) & 0x01]);
@@ -498,15 +589,12 @@ void cmdMap(const char *)
 {
     static const char hexchars[] = "0123456789ABCDEF";
     uint8_t value;
+    uint8_t regs[0x14];
 
-    Wire.beginTransmission(DS3232_I2C_ADDRESS);
-    Wire.write(0x00);  // sends 00h - Seconds register
-    Wire.endTransmission();
-
-    Wire.requestFrom(DS3232_I2C_ADDRESS, 0x14);
+    RTC.bus().read(0x00, regs, 0x14);  // 00h - Seconds register
 
     for (int offset = 0; offset < 0x14; offset++) {
-        value = Wire.read();
+        value = regs[offset];
 
         if (offset % 7 == 0) {
             if (offset != 0) Serial.println();
@@ -523,6 +611,42 @@ void cmdMap(const char *)
     Serial.println();
 }
 
+// "TRACE" command
+void cmdTrace(const char *args)
+{
+    static const char hexchars[] = "0123456789ABCDEF";
+    uint8_t chunk[FRAME_CHUNK];
+
+    if (matchString(s_ON, args, strlen(args))) {
+        trace.clear();
+        RTC.setBus(trace);
+        Serial.println("Tracing");
+        return;
+    } else if (matchString(s_OFF, args, strlen(args))) {
+        RTC.setBus(wireBus);
+        Serial.println("Not tracing");
+        return;
+    } else if (*args != '\0') {
+        Serial.println("Use ON, OFF or nothing to print the trace");
+        return;
+    }
+
+    // Print the trace, oldest record first.
+    Serial.print(trace.used(), DEC);
+    Serial.print(" bytes, ");
+    Serial.print(trace.dropped(), DEC);
+    Serial.println(" records dropped");
+    for (uint16_t offset = 0; offset < trace.used(); offset += sizeof(chunk)) {
+        uint16_t count = trace.copy(offset, chunk, sizeof(chunk));
+        for (uint16_t i = 0; i < count; i++) {
+            Serial.print(hexchars[(chunk[i] >> 4) & 0x0F]);
+            Serial.print(hexchars[chunk[i] & 0x0F]);
+            Serial.print(' ');
+        }
+        Serial.println();
+    }
+}
+
 // List of all commands that are understood by the sketch.
 typedef void (*commandFunc)(const char *args);
 typedef struct
@@ -540,6 +664,10 @@ const char s_cmdDate[] PROGMEM = "DATE";
 const char s_cmdDateDesc[] PROGMEM =
     "Read or write the current date";
 const char s_cmdDateArgs[] PROGMEM = "[YYYYMMDD]";
+const char s_cmdIso[] PROGMEM = "ISO";
+const char s_cmdIsoDesc[] PROGMEM =
+    "Read or write the date and time in ISO 8601";
+const char s_cmdIsoArgs[] PROGMEM = "[YYYY-MM-DDTHH:MM:SS]";
 const char s_cmdTemp[] PROGMEM = "TEMP";
 const char s_cmdTempDesc[] PROGMEM =
     "Read the current temperature";
@@ -563,12 +691,17 @@ const char s_cmdRegistersDesc[] PROGMEM =
 const char s_cmdMap[] PROGMEM = "MAP";
 const char s_cmdMapDesc[] PROGMEM =
     "Print the content of Address Map";
+const char s_cmdTrace[] PROGMEM = "TRACE";
+const char s_cmdTraceDesc[] PROGMEM =
+    "Record register traffic, or print what was recorded";
+const char s_cmdTraceArgs[] PROGMEM = "[ON|OFF]";
 const char s_cmdHelp[] PROGMEM = "HELP";
 const char s_cmdHelpDesc[] PROGMEM =
     "Prints this help message";
 const command_t commands[] PROGMEM = {
     {s_cmdTime, cmdTime, s_cmdTimeDesc, s_cmdTimeArgs},
     {s_cmdDate, cmdDate, s_cmdDateDesc, s_cmdDateArgs},
+    {s_cmdIso, cmdIso, s_cmdIsoDesc, s_cmdIsoArgs},
     {s_cmdTemp, cmdTemp, s_cmdTempDesc, 0},
     {s_cmdAlarms, cmdAlarms, s_cmdAlarmsDesc, 0},
     {s_cmdAlarm, cmdAlarm, s_cmdAlarmDesc, s_cmdAlarmArgs},
@@ -576,6 +709,7 @@ const command_t commands[] PROGMEM = {
     {s_cmdDump, cmdDump, s_cmdDumpDesc, s_cmdDumpArgs},
     {s_cmdRegisters, cmdRegisters, s_cmdRegistersDesc, 0},
     {s_cmdMap, cmdMap, s_cmdMapDesc, 0},
+    {s_cmdTrace, cmdTrace, s_cmdTraceDesc, s_cmdTraceArgs},
     {s_cmdHelp, cmdHelp, s_cmdHelpDesc, 0},
     {0, 0}
 };
@@ -673,3 +807,178 @@ void processCommand(const char *buf)
     Serial.println("Unknown command, valid commands are:");
     cmdHelp(0);
 }
+
+// Update a CRC-8/Maxim with one byte.
+uint8_t crc8(uint8_t crc, uint8_t data)
+{
+    crc ^= data;
+    for (byte i = 0; i < 8; i++)
+        crc = (crc & 0x01) ? ((crc >> 1) ^ 0x8C) : (crc >> 1);
+    return crc;
+}
+
+// Collect the bytes of a binary frame after the sync byte.
+void frameByte(uint8_t ch)
+{
+    frame[framepos++] = ch;
+    if (framepos == 2) {
+        framelen = frame[0] | (frame[1] << 8);
+        if (framelen > FRAME_MAX) {
+            inFrame = false;
+            sendReject();
+        }
+    } else if (framepos > 2 && framepos == framelen + 3) {
+        inFrame = false;
+        processFrame();
+    }
+}
+
+void sendByte(uint8_t b)
+{
+    Serial.write(b);
+    txcrc = crc8(txcrc, b);
+}
+
+void sendBytes(const uint8_t *buf, uint16_t len)
+{
+    Serial.write(buf, len);
+    while (len--)
+        txcrc = crc8(txcrc, *buf++);
+}
+
+void sendHeader(uint16_t len)
+{
+    Serial.write(FRAME_SYNC);
+    txcrc = 0;
+    sendByte(len & 0xFF);
+    sendByte(len >> 8);
+}
+
+void sendReject()
+{
+    sendHeader(1);
+    sendByte(FRAME_REJECT);
+    Serial.write(txcrc);
+}
+
+// Size of the operation at op (0 if malformed) and of its response.
+uint16_t opSize(const uint8_t *op, uint16_t left, uint16_t &resp)
+{
+    resp = 1;  // status
+    switch (op[0]) {
+        case OP_READ_REGS:
+        case OP_READ_SRAM:
+            if (left < 3)
+                return 0;
+            if (op[2] > 0)
+                resp = op[2] + (op[2] + FRAME_CHUNK - 1) / FRAME_CHUNK;
+            return 3;
+        case OP_WRITE_REGS:
+        case OP_WRITE_SRAM:
+            if (left < 3 || left < 3 + op[2])
+                return 0;
+            return 3 + op[2];
+        case OP_GET_TIME:
+            resp += 4;
+            return 1;
+        case OP_SET_TIME:
+            return (left < 5) ? 0 : 5;
+    }
+    return 0;
+}
+
+// Run one operation and stream its response.
+void runOp(const uint8_t *op)
+{
+    uint8_t chunk[FRAME_CHUNK];
+    uint8_t addr = op[1];
+    uint8_t count = op[2];
+    uint8_t done = 0;
+    time_t t;
+    tmElements_t tm;
+
+    switch (op[0]) {
+        case OP_READ_REGS:
+        case OP_READ_SRAM:
+            // Burst read, streamed out through a small buffer with a
+            // status byte ahead of each chunk.
+            while (done < count) {
+                uint8_t n = count - done;
+                if (n > sizeof(chunk))
+                    n = sizeof(chunk);
+                uint8_t got = (op[0] == OP_READ_REGS)
+                    ? RTC.bus().read(addr + done, chunk, n)
+                    : SRAM.read(addr + done, chunk, n);
+                sendByte((got == n) ? STATUS_OK : STATUS_BUS);
+                if (got < n)
+                    memset(chunk + got, 0, n - got);
+                sendBytes(chunk, n);
+                done += n;
+            }
+            if (count == 0)
+                sendByte(STATUS_OK);
+            break;
+        case OP_WRITE_REGS:
+            sendByte((RTC.bus().write(addr, op + 3, count) == count) ? STATUS_OK : STATUS_BUS);
+            break;
+        case OP_WRITE_SRAM:
+            sendByte((SRAM.write(addr, op + 3, count) == count) ? STATUS_OK : STATUS_BUS);
+            break;
+        case OP_GET_TIME:
+            // Read 00h~06h here, RTC.get() can't report a bus error.
+            if (RTC.bus().read(0x00, chunk, 7) == 7) {
+                DS3232RTC::decodeTime(chunk, tm);
+                t = makeTime(tm);
+                sendByte(STATUS_OK);
+            } else {
+                t = 0;
+                sendByte(STATUS_BUS);
+            }
+            for (byte i = 0; i < 4; i++)
+                sendByte(((uint32_t)t >> (8 * i)) & 0xFF);
+            break;
+        case OP_SET_TIME:
+            t = (time_t)((uint32_t)op[1] | ((uint32_t)op[2] << 8) |
+                ((uint32_t)op[3] << 16) | ((uint32_t)op[4] << 24));
+            // A 32 bit time_t ends in 2106, so only the start needs a check.
+            if ((uint32_t)t < RTC_FIRST_TIME) {
+                sendByte(STATUS_RANGE);
+                break;
+            }
+            RTC.set(t);
+            sendByte(STATUS_OK);
+            break;
+    }
+}
+
+// Check and run a complete binary frame, then send the response frame.
+void processFrame()
+{
+    const uint8_t *payload = frame + 2;
+    uint16_t pos, size, resp, total = 0;
+    uint8_t crc = 0;
+
+    for (pos = 0; pos < framelen + 2; pos++)
+        crc = crc8(crc, frame[pos]);
+    if (crc != frame[framelen + 2]) {
+        sendReject();
+        return;
+    }
+
+    // First pass validates the batch and sizes the response.
+    for (pos = 0; pos < framelen; pos += size) {
+        size = opSize(payload + pos, framelen - pos, resp);
+        if (size == 0) {
+            sendReject();
+            return;
+        }
+        total += resp;
+    }
+
+    sendHeader(total);
+    for (pos = 0; pos < framelen; pos += size) {
+        size = opSize(payload + pos, framelen - pos, resp);
+        runOp(payload + pos);
+    }
+    Serial.write(txcrc);
+}
@@ -0,0 +1,23 @@
+/*
+ * bench.h - wall clock timing for the host benchmarks
+ */
+
+#ifndef bench_h
+#define bench_h
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * \brief Monotonic time in nanoseconds
+ */
+static inline uint64_t benchNow() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Stops the compiler from dropping a result
+static volatile uint32_t benchSink;
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * bench_decode.cpp - records per second of the batch decoders
+ * The batch takes the SSE2 or AVX2 path on x86 hosts, the one block call
+ * is the scalar code the device runs.
+ */
+
+#include <stdlib.h>
+#include "DS3232RTC.h"
+#include "DS3232Decode.h"
+#include "bench.h"
+
+#define RECORDS 1000000UL
+#define ROUNDS 20
+
+#if defined(DS3232_NO_SIMD)
+#define DECODE_PATH "scalar"
+#elif defined(__AVX2__)
+#define DECODE_PATH "avx2"
+#elif defined(__SSE2__)
+#define DECODE_PATH "sse2"
+#else
+#define DECODE_PATH "scalar"
+#endif
+
+static void report(const char *name, uint64_t ns, unsigned long records) {
+  printf("  %-28s %7.1f M records/s  %5.2f ns/record\n", name,
+    records * 1e3 / ns, (double)ns / records);
+}
+
+int main() {
+  static uint8_t blocks[RECORDS * DS3232_TIME_BLOCK];
+  static uint8_t alarms[RECORDS / 4 * DS3232_ALARM_BLOCK];
+  static uint32_t out[RECORDS];
+  static alarmElements_t decoded[RECORDS / 2];
+  tmElements_t tm;
+  uint64_t t0;
+  uint32_t sum = 0;
+  unsigned long i;
+  int r;
+
+  printf("bench_decode: %s path\n", DECODE_PATH);
+
+  // A dump of readings a minute and a bit apart from 2023 on
+  for (i = 0; i < RECORDS; i++) {
+    breakTime(1700000000UL + i * 61, tm);
+    DS3232RTC::encodeTime(tm, blocks + i * DS3232_TIME_BLOCK);
+  }
+  srand(1);
+  for (i = 0; i < sizeof(alarms); i++) alarms[i] = rand();
+
+  t0 = benchNow();
+  for (r = 0; r < ROUNDS; r++) {
+    ds3232DecodeTimes(blocks, RECORDS, out);
+    sum += out[r];
+  }
+  report("ds3232DecodeTimes()", benchNow() - t0, RECORDS * ROUNDS);
+
+  t0 = benchNow();
+  for (r = 0; r < ROUNDS; r++) {
+    for (i = 0; i < RECORDS; i++) out[i] = ds3232DecodeTime(blocks + i * DS3232_TIME_BLOCK);
+    sum += out[r];
+  }
+  report("ds3232DecodeTime() each", benchNow() - t0, RECORDS * ROUNDS);
+
+  t0 = benchNow();
+  for (i = 0; i < RECORDS; i++) {
+    DS3232RTC::decodeTime(blocks + i * DS3232_TIME_BLOCK, tm);
+    out[i] = makeTime(tm);
+  }
+  sum += out[RECORDS - 1];
+  report("decodeTime() + makeTime()", benchNow() - t0, RECORDS);
+
+  t0 = benchNow();
+  for (r = 0; r < ROUNDS; r++) {
+    ds3232DecodeAlarms(alarms, RECORDS / 4, decoded);
+    sum += decoded[r].Minute;
+  }
+  report("ds3232DecodeAlarms() alarms", benchNow() - t0, RECORDS / 2 * ROUNDS);
+
+  benchSink = sum;
+  return 0;
+}
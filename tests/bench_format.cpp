@@ -0,0 +1,131 @@
+/*
+ * bench_format.cpp - formatISO8601()/parseISO8601() against the TestRTC
+ * printDec2()/Serial.print() and readField() way of doing the same
+ */
+
+#include "DS3232Format.h"
+#include "bench.h"
+
+#define STAMPS 2000000UL
+
+/**
+ * Print sink counting the calls a timestamp costs
+ */
+class CountingPrint : public Print
+{
+  public:
+    CountingPrint() : calls(0), bytes(0) {}
+    virtual size_t write(uint8_t c) {
+      calls++;
+      bytes++;
+      sum += c;
+      return 1;
+    }
+    virtual size_t write(const uint8_t *buf, size_t size) {
+      calls++;
+      bytes += size;
+      sum += buf[size - 1];
+      return size;
+    }
+    unsigned long calls;
+    unsigned long bytes;
+    uint32_t sum;
+};
+
+static CountingPrint out;
+
+// As TestRTC
+static void printDec2(int value) {
+  out.print((char)('0' + (value / 10)));
+  out.print((char)('0' + (value % 10)));
+}
+
+static void printOld(const tmElements_t &tm) {
+  uint16_t year = tmYearToCalendar(tm.Year);
+  printDec2(year / 100);
+  printDec2(year % 100);
+  out.print('-');
+  printDec2(tm.Month);
+  out.print('-');
+  printDec2(tm.Day);
+  out.print('T');
+  printDec2(tm.Hour);
+  out.print(':');
+  printDec2(tm.Minute);
+  out.print(':');
+  printDec2(tm.Second);
+}
+
+static void printNew(const tmElements_t &tm) {
+  char iso[DS3232_ISO8601_LEN + 1];
+  out.write((const uint8_t *)iso, formatISO8601(iso, tm));
+}
+
+// As TestRTC
+static uint8_t readField(const char *args, int &posn, int maxValue) {
+  int value = -1;
+  if (args[posn] == ':' && posn != 0) ++posn;
+  while (args[posn] >= '0' && args[posn] <= '9') {
+    if (value == -1) value = 0;
+    value = (value * 10) + (args[posn++] - '0');
+    if (value > 99) return 99;
+  }
+  return (value == -1 || value > maxValue) ? 99 : value;
+}
+
+// cmdDate and cmdTime arguments, "YYYYMMDD" and "HH:MM:SS"
+static bool parseOld(const char *date, const char *time, tmElements_t &tm) {
+  unsigned long value = 0;
+  int posn = 0;
+  while (*date >= '0' && *date <= '9') value = value * 10 + (*date++ - '0');
+  if (value < 20000000 || value >= 22000000) return false;
+  tm.Day = value % 100;
+  tm.Month = (value / 100) % 100;
+  tm.Year = CalendarYrToTm(value / 10000);
+  tm.Hour = readField(time, posn, 23);
+  tm.Minute = readField(time, posn, 59);
+  tm.Second = readField(time, posn, 59);
+  return (tm.Hour != 99) && (tm.Minute != 99) && (tm.Second != 99);
+}
+
+int main() {
+  static char iso[64][DS3232_ISO8601_LEN + 1], date[64][9], time[64][9];
+  tmElements_t tm[64], back;
+  unsigned long i, calls;
+  uint64_t t0, t1;
+  uint32_t sum = 0;
+
+  for (i = 0; i < 64; i++) {
+    breakTime(946684800UL + i * 86413UL * 97, tm[i]);
+    formatISO8601(iso[i], tm[i]);
+    snprintf(date[i], sizeof(date[i]), "%.4s%.2s%.2s", iso[i], iso[i] + 5, iso[i] + 8);
+    memcpy(time[i], iso[i] + DS3232_ISO8601_TIME, 8);
+    time[i][8] = '\0';
+  }
+
+  printf("bench_format: %lu timestamps\n", STAMPS);
+  t0 = benchNow();
+  for (i = 0; i < STAMPS; i++) printOld(tm[i & 63]);
+  t1 = benchNow();
+  calls = out.calls;
+  printf("  printDec2/print  %6.1f ns/timestamp  %4.1f Print calls\n",
+    (double)(t1 - t0) / STAMPS, (double)calls / STAMPS);
+  out.calls = 0;
+  t0 = benchNow();
+  for (i = 0; i < STAMPS; i++) printNew(tm[i & 63]);
+  t1 = benchNow();
+  printf("  formatISO8601    %6.1f ns/timestamp  %4.1f Print calls\n",
+    (double)(t1 - t0) / STAMPS, (double)out.calls / STAMPS);
+
+  t0 = benchNow();
+  for (i = 0; i < STAMPS; i++) sum += parseOld(date[i & 63], time[i & 63], back) + back.Second;
+  t1 = benchNow();
+  printf("  readField parse  %6.1f ns/timestamp\n", (double)(t1 - t0) / STAMPS);
+  t0 = benchNow();
+  for (i = 0; i < STAMPS; i++) sum += parseISO8601(iso[i & 63], back) + back.Second;
+  t1 = benchNow();
+  printf("  parseISO8601     %6.1f ns/timestamp (also validates the day and sets Wday)\n",
+    (double)(t1 - t0) / STAMPS);
+  benchSink = sum + out.sum;
+  return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * bench_log.cpp - bytes per event and codec throughput of DS3232Log
+ * A raw record is a 4 byte time_t plus a 1 byte code, 5 bytes.
+ */
+
+#include <stdlib.h>
+#include "DS3232Log.h"
+#include "bench.h"
+
+#define RAW_RECORD 5
+#define CODEC_RECORDS 10000000UL
+
+/**
+ * \brief Fill the whole SRAM with events spaced lo~hi seconds apart
+ */
+static void fill(const char *name, uint32_t lo, uint32_t hi) {
+  time_t t = 1700000000;
+  unsigned long tx;
+  int n = 0;
+
+  Wire.reset();
+  DS3232Log log(0, DS3232_SRAM_SIZE, 4);
+  log.begin(t);
+  tx = Wire.transactions;
+  for (;;) {
+    t += lo + (uint32_t)rand() % (hi - lo + 1);
+    if (!log.append(t, n & 15)) break;
+    n++;
+  }
+  tx = Wire.transactions - tx;
+  printf("  %-14s %4d events  %.2f bytes/event  %.2fx raw  (raw fits %d)  %.1f Wire transactions/append\n",
+    name, n, (double)log.used() / n, (double)RAW_RECORD * n / log.used(),
+    (DS3232_SRAM_SIZE - DS3232LOG_HEADER) / RAW_RECORD, (double)tx / n);
+}
+
+int main() {
+  static uint8_t buf[CODEC_RECORDS * 2];
+  uint32_t i, delta, sum = 0, expect = 0;
+  uint8_t code, n;
+  size_t encoded;
+  uint64_t t0, t1, t2;
+  size_t pos = 0;
+
+  printf("bench_log: 4 code bits, %u bytes of SRAM\n", DS3232_SRAM_SIZE);
+  srand(1);
+  fill("1~7 s", 1, 7);
+  fill("1~60 s", 1, 60);
+  fill("1~15 min", 60, 900);
+  fill("15~60 min", 900, 3600);
+  fill("1~24 h", 3600, 86400);
+
+  // codec alone, deltas of 0~1023 s (1 or 2 bytes), hashed in 32 bits
+  t0 = benchNow();
+  for (i = 0; i < CODEC_RECORDS; i++) {
+    n = DS3232Log::encode(buf + pos, (uint32_t)(i * 2654435761u) >> 22, i & 15, 4);
+    if (n == 0) break;
+    pos += n;
+  }
+  t1 = benchNow();
+  if (i != CODEC_RECORDS) {
+    printf("  encode failed at record %lu\n", (unsigned long)i);
+    return 1;
+  }
+  encoded = pos;
+  for (i = 0, pos = 0; i < CODEC_RECORDS; i++) {
+    pos += DS3232Log::decode(buf + pos, DS3232LOG_MAX_VARINT, delta, code, 4);
+    sum += delta + code;
+  }
+  t2 = benchNow();
+  benchSink = sum;
+  for (i = 0; i < CODEC_RECORDS; i++) expect += ((uint32_t)(i * 2654435761u) >> 22) + (i & 15);
+  if ((pos != encoded) || (sum != expect)) {
+    printf("  decode doesn't match the records encoded\n");
+    return 1;
+  }
+  printf("  encode %.1f M records/s, decode %.1f M records/s (%.2f bytes/record)\n",
+    CODEC_RECORDS * 1e3 / (t1 - t0), CODEC_RECORDS * 1e3 / (t2 - t1), (double)pos / CODEC_RECORDS);
+  return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * bench_timezone.cpp - cost of a DS3232Timezone conversion
+ * Readings a second apart stay in the cached interval, random times
+ * across the years refill the transitions on most calls.
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "DS3232Timezone.h"
+#include "bench.h"
+
+#define CALLS 10000000UL
+#define RANDOM 1000000UL
+
+static time_t randomTime[RANDOM];
+
+static void report(const char *name, uint64_t ns, unsigned long calls) {
+  printf("  %-34s %7.2f ns/call\n", name, (double)ns / calls);
+}
+
+static void run(const char *zone) {
+  DS3232Timezone tz;
+  uint64_t t0;
+  uint32_t sum = 0;
+  unsigned long i;
+  time_t t;
+
+  tz.begin(zone);
+  printf("  %s\n", zone);
+
+  t0 = benchNow();
+  for (i = 0, t = 1700000000; i < CALLS; i++, t++) sum += tz.toLocal(t);
+  report("toLocal(), a second apart", benchNow() - t0, CALLS);
+
+  t0 = benchNow();
+  for (i = 0; i < RANDOM; i++) sum += tz.toLocal(randomTime[i]);
+  report("toLocal(), random 1970~2106", benchNow() - t0, RANDOM);
+
+  t0 = benchNow();
+  for (i = 0, t = 1700000000; i < CALLS; i++, t++) sum += tz.toUTC(t);
+  report("toUTC(), a second apart", benchNow() - t0, CALLS);
+
+  setenv("TZ", zone, 1);
+  tzset();
+  t0 = benchNow();
+  for (i = 0, t = 1700000000; i < RANDOM; i++, t++) {
+    struct tm lt;
+    localtime_r(&t, &lt);
+    sum += lt.tm_gmtoff;
+  }
+  report("localtime_r(), a second apart", benchNow() - t0, RANDOM);
+  benchSink = sum;
+}
+
+int main() {
+  unsigned long i;
+
+  printf("bench_timezone:\n");
+  srand(5);
+  for (i = 0; i < RANDOM; i++) randomTime[i] = ((uint64_t)rand() * RAND_MAX + rand()) % 0xFFFFFFFFUL;
+  run("CET-1CEST,M3.5.0,M10.5.0/3");
+  run("<+0330>-3:30");
+  return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * check.h - minimal assertions for the host tests
+ * Each test program returns non-zero when any CHECK failed.
+ */
+
+#ifndef check_h
+#define check_h
+
+#include <stdio.h>
+
+static int checkFailures = 0;
+
+// Failures past this many are counted but not printed
+#define CHECK_PRINT_MAX 20
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      if (checkFailures++ < CHECK_PRINT_MAX) \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long _a = (long long)(a), _b = (long long)(b); \
+    if (_a != _b) { \
+      if (checkFailures++ < CHECK_PRINT_MAX) \
+        printf("%s:%d: CHECK_EQ(%s, %s) failed, %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+    } \
+  } while (0)
+
+/**
+ * \brief Print the result of the test program, returns its exit status
+ */
+static inline int checkDone(const char *name) {
+  if (checkFailures == 0) {
+    printf("%s: ok\n", name);
+  } else {
+    printf("%s: FAILED, %d checks\n", name, checkFailures);
+  }
+  return (checkFailures == 0) ? 0 : 1;
+}
+
+#endif
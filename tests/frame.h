@@ -0,0 +1,185 @@
+/*
+ * frame.h - host side of the TestRTC binary protocol
+ * Builds request frames and picks the operation results out of the
+ * response frame (see the notes at the top of TestRTC.ino).
+ */
+
+#ifndef frame_h
+#define frame_h
+
+#include <stdint.h>
+#include <string.h>
+
+#define FRAME_SYNC      0xA5
+#define FRAME_MAX       64    // request payload limit of the sketch
+#define FRAME_CHUNK     16    // read bytes per status byte
+#define FRAME_REJECT    0xFF
+#define FRAME_OPS       32
+#define OP_READ_REGS    0x01
+#define OP_WRITE_REGS   0x02
+#define OP_READ_SRAM    0x03
+#define OP_WRITE_SRAM   0x04
+#define OP_GET_TIME     0x05
+#define OP_SET_TIME     0x06
+#define STATUS_OK       0x00
+#define STATUS_BUS      0x01
+#define STATUS_RANGE    0x02
+
+/**
+ * \brief Update a CRC-8/Maxim with one byte
+ */
+static inline uint8_t frameCrc8(uint8_t crc, uint8_t data) {
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x01) ? ((crc >> 1) ^ 0x8C) : (crc >> 1);
+  }
+  return crc;
+}
+
+/**
+ * \brief Find a complete frame at the start of buf
+ * \return Its size, 0 while more bytes are needed, -1 if it isn't a
+ *         frame or fails the CRC
+ */
+static inline int frameDecode(const uint8_t *buf, size_t size, const uint8_t **payload, uint16_t *len) {
+  uint8_t crc = 0;
+  size_t i;
+
+  if (size == 0) return 0;
+  if (buf[0] != FRAME_SYNC) return -1;
+  if (size < 3) return 0;
+  *len = buf[1] | (buf[2] << 8);
+  if (size < (size_t)*len + 4) return 0;
+  for (i = 1; i < (size_t)*len + 3; i++) crc = frameCrc8(crc, buf[i]);
+  if (crc != buf[*len + 3]) return -1;
+  *payload = buf + 3;
+  return *len + 4;
+}
+
+/**
+ * FrameRequest Class
+ * A batch of operations, see TestRTC.ino for what each one does
+ */
+class FrameRequest
+{
+  public:
+    FrameRequest() : _len(0), _ops(0) {}
+    void clear() { _len = _ops = 0; }
+    bool readRegs(uint8_t addr, uint8_t count) { return add(OP_READ_REGS, addr, count, 0); }
+    bool writeRegs(uint8_t addr, const uint8_t *data, uint8_t count) { return add(OP_WRITE_REGS, addr, count, data); }
+    bool readSRAM(uint8_t addr, uint8_t count) { return add(OP_READ_SRAM, addr, count, 0); }
+    bool writeSRAM(uint8_t addr, const uint8_t *data, uint8_t count) { return add(OP_WRITE_SRAM, addr, count, data); }
+    bool getTime() {
+      if ((_len + 1 > FRAME_MAX) || (_ops >= FRAME_OPS)) return false;
+      _at[_ops++] = _len;
+      _payload[_len++] = OP_GET_TIME;
+      return true;
+    }
+    bool setTime(uint32_t t) {
+      if ((_len + 5 > FRAME_MAX) || (_ops >= FRAME_OPS)) return false;
+      _at[_ops++] = _len;
+      _payload[_len++] = OP_SET_TIME;
+      for (uint8_t i = 0; i < 4; i++) _payload[_len++] = (t >> (8 * i)) & 0xFF;
+      return true;
+    }
+    uint8_t ops() const { return _ops; }
+
+    /**
+     * \brief Code, address and count of operation index (0 when unused)
+     */
+    void opAt(uint8_t index, uint8_t *op) const {
+      const uint8_t *p = _payload + _at[index];
+      bool ranged = (p[0] >= OP_READ_REGS) && (p[0] <= OP_WRITE_SRAM);
+      op[0] = p[0];
+      op[1] = ranged ? p[1] : 0;
+      op[2] = ranged ? p[2] : 0;
+    }
+
+    /**
+     * \brief Frame the batch into out (FRAME_MAX + 4 bytes), returns its size
+     */
+    uint16_t encode(uint8_t *out) const {
+      uint8_t crc = 0;
+      uint16_t i;
+
+      out[0] = FRAME_SYNC;
+      out[1] = _len & 0xFF;
+      out[2] = _len >> 8;
+      memcpy(out + 3, _payload, _len);
+      for (i = 1; i < _len + 3; i++) crc = frameCrc8(crc, out[i]);
+      out[_len + 3] = crc;
+      return _len + 4;
+    }
+
+    /**
+     * \brief Payload size of the response to the batch
+     */
+    uint16_t responseSize() const {
+      uint16_t total = 0;
+      for (uint8_t i = 0; i < _ops; i++) total += respSize(_payload + _at[i]);
+      return total;
+    }
+
+    /**
+     * \brief Status and data of operation index in a response payload
+     * \return The worst status of its chunks, FRAME_REJECT if the
+     *         response was a reject or doesn't match the batch
+     */
+    uint8_t result(const uint8_t *payload, uint16_t len, uint8_t index, uint8_t *data = 0) const {
+      uint16_t pos = 0, count, n;
+      uint8_t status = STATUS_OK;
+      const uint8_t *op;
+
+      if ((index >= _ops) || (len != responseSize())) return FRAME_REJECT;
+      for (uint8_t i = 0; i < index; i++) pos += respSize(_payload + _at[i]);
+      op = _payload + _at[index];
+      switch (op[0]) {
+        case OP_READ_REGS:
+        case OP_READ_SRAM:
+          if (op[2] == 0) return payload[pos];
+          for (count = 0; count < op[2]; count += n) {
+            n = op[2] - count;
+            if (n > FRAME_CHUNK) n = FRAME_CHUNK;
+            if (payload[pos] > status) status = payload[pos];
+            if (data) memcpy(data + count, payload + pos + 1, n);
+            pos += n + 1;
+          }
+          return status;
+        case OP_GET_TIME:
+          if (data) memcpy(data, payload + pos + 1, 4);
+          return payload[pos];
+      }
+      return payload[pos];
+    }
+
+  private:
+    bool add(uint8_t code, uint8_t addr, uint8_t count, const uint8_t *data) {
+      uint16_t size = data ? 3 + count : 3;
+      if ((_len + size > FRAME_MAX) || (_ops >= FRAME_OPS)) return false;
+      _at[_ops++] = _len;
+      _payload[_len++] = code;
+      _payload[_len++] = addr;
+      _payload[_len++] = count;
+      if (data) {
+        memcpy(_payload + _len, data, count);
+        _len += count;
+      }
+      return true;
+    }
+    static uint16_t respSize(const uint8_t *op) {
+      switch (op[0]) {
+        case OP_READ_REGS:
+        case OP_READ_SRAM:
+          return (op[2] == 0) ? 1 : op[2] + (op[2] + FRAME_CHUNK - 1) / FRAME_CHUNK;
+        case OP_GET_TIME:
+          return 5;
+      }
+      return 1;
+    }
+    uint8_t _payload[FRAME_MAX];
+    uint16_t _len;
+    uint16_t _at[FRAME_OPS];
+    uint8_t _ops;
+};
+
+#endif
@@ -0,0 +1,12 @@
+#!/bin/sh
+# ino2cpp.sh - turn a sketch into C++ the way the Arduino IDE does, with
+# Arduino.h included and every function declared ahead of the sketch
+#
+#   ./ino2cpp.sh Sketch.ino > Sketch.cpp
+
+ino=$1
+echo '#include <Arduino.h>'
+grep '^#include' "$ino"
+sed -n 's/^\(void\|bool\|byte\|int\|uint8_t\|uint16_t\|size_t\|time_t\) \([A-Za-z0-9_]*([^)]*)\).*$/\1 \2;/p' "$ino"
+echo "#line 1 \"$ino\""
+cat "$ino"
@@ -0,0 +1,128 @@
+/*
+ * replay.cpp - replay a TestRTC TRACE dump against the simulated DS3232
+ *
+ *   build/replay [-v] [file]    (standard input without a file)
+ *
+ * The input is the output of the TRACE command, the hex bytes of
+ * DS3232Trace records (see DS3232Trace.h); other lines are skipped.
+ * Every record is issued again through DS3232Replay, for the transaction
+ * count and recorded bus time, and against the register simulator behind
+ * DS3232Wire, where a read that disagrees with what the trace wrote
+ * earlier is reported.
+ */
+
+#include <stdlib.h>
+#include <ctype.h>
+#include "DS3232Trace.h"
+
+#define TRACE_MAX 65535
+
+static uint8_t trace[TRACE_MAX];
+
+/**
+ * \brief Collect the hex bytes of the lines made of nothing else
+ */
+static uint16_t load(FILE *in) {
+  char line[256], *p;
+  uint16_t size = 0;
+  unsigned value;
+  int n;
+
+  while (fgets(line, sizeof(line), in)) {
+    for (p = line; *p; p++) {
+      if (!isxdigit((unsigned char)*p) && !isspace((unsigned char)*p)) break;
+    }
+    if (*p != '\0') continue;  // header or other console output
+    for (p = line; sscanf(p, " %2x%n", &value, &n) == 1; p += n) {
+      if (size < TRACE_MAX) trace[size++] = value;
+    }
+  }
+  return size;
+}
+
+int main(int argc, char **argv) {
+  static uint8_t known[256];  // simulator bytes the trace has written
+  bool verbose = false;
+  FILE *in = stdin;
+  uint16_t size, pos;
+  unsigned long records = 0, reads = 0, writes = 0, sram = 0, differ = 0, wireTx;
+  unsigned long maxTime = 0;
+  uint8_t buf[256];
+  int i;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) {
+      verbose = true;
+    } else if (!(in = fopen(argv[i], "r"))) {
+      perror(argv[i]);
+      return 2;
+    }
+  }
+  size = load(in);
+
+  DS3232Replay replay(trace, size);
+  DS3232Wire sim(Wire);
+  Wire.reset();
+  wireTx = Wire.transactions;
+
+  for (pos = 0; pos + DS3232TRACE_HEADER <= size; ) {
+    const uint8_t *rec = trace + pos;
+    uint8_t flags = rec[0], addr = rec[1], n = rec[2];
+    unsigned long duration = rec[5] | (rec[6] << 8);
+    const uint8_t *data = rec + DS3232TRACE_HEADER;
+    uint16_t base = (flags & DS3232TRACE_SRAM) ? 0x14 + addr : addr;
+    bool bad = false;
+    uint8_t k;
+
+    if (pos + DS3232TRACE_HEADER + n > size) break;
+    records++;
+    if (duration > maxTime) maxTime = duration;
+    if (flags & DS3232TRACE_SRAM) sram++;
+
+    if (flags & DS3232TRACE_WRITE) {
+      writes++;
+      if (flags & DS3232TRACE_SRAM) {
+        replay.writeSRAM(addr, data, n);
+        sim.writeSRAM(addr, data, n);
+      } else {
+        replay.write(addr, data, n);
+        sim.write(addr, data, n);
+      }
+      for (k = 0; k < n; k++) known[(base + k) & 0xFF] = 1;
+    } else {
+      reads++;
+      if (flags & DS3232TRACE_SRAM) {
+        replay.readSRAM(addr, buf, n);
+        sim.readSRAM(addr, buf, n);
+      } else {
+        replay.read(addr, buf, n);
+        sim.read(addr, buf, n);
+      }
+      for (k = 0; k < n; k++) {
+        uint8_t r = (base + k) & 0xFF;
+        // 00h~06h tick and 11h~12h are the temperature, both change on their own
+        if (known[r] && (r > 0x06) && (r != 0x11) && (r != 0x12) && (buf[k] != data[k])) bad = true;
+        Wire.regs[r] = data[k];  // follow the field unit from here on
+        known[r] = 1;
+      }
+      if (bad) differ++;
+    }
+
+    if (verbose) {
+      printf("%5lu %s%s %02X %3u %5u us%s", records, (flags & DS3232TRACE_WRITE) ? "W" : "R",
+        (flags & DS3232TRACE_SRAM) ? "S" : " ", addr, n, (unsigned)duration, bad ? "  DIFFERS" : "");
+      for (k = 0; k < n && k < 16; k++) printf("%s%02X", k ? " " : "  ", data[k]);
+      printf("%s\n", (n > 16) ? " ..." : "");
+    }
+    pos += DS3232TRACE_HEADER + n;
+  }
+
+  printf("trace:     %u bytes, %lu records (%lu reads, %lu writes, %lu SRAM)%s\n",
+    size, records, reads, writes, sram, (pos != size) ? ", truncated record at the end" : "");
+  printf("replay:    %u transactions, %lu bytes, %lu us recorded bus time (longest %lu us), %u mismatches\n",
+    replay.transactions(), (unsigned long)replay.bytes(), (unsigned long)replay.busTime(), maxTime,
+    replay.mismatches());
+  printf("simulator: %lu Wire transactions, %lu bytes on the bus, %lu reads differing from earlier writes\n",
+    Wire.transactions - wireTx, Wire.bytes, differ);
+  return (differ || replay.mismatches() || (pos != size)) ? 1 : 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * rtcframe.cpp - send a batch of operations to the TestRTC sketch
+ *
+ *   build/rtcframe port [op...]
+ *
+ *     regs addr count         read registers
+ *     setregs addr xx...      write registers
+ *     sram addr count         read SRAM
+ *     setsram addr xx...      write SRAM
+ *     time                    read the time as time_t
+ *     settime t               set the time from time_t
+ *
+ * Without operations it reads registers 00h~13h and all of SRAM.  Numbers
+ * take C syntax, data bytes are hex.  The port is opened at 115200 baud;
+ * opening it resets most boards, so the sketch gets two seconds to start
+ * and its HELP banner is skipped.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include "frame.h"
+
+#define DATA_MAX    (FRAME_MAX - 3)  // a write alone in the frame
+#define RESET_WAIT  2000  // ms
+#define REPLY_WAIT  1000  // ms
+
+static int openPort(const char *name) {
+  struct termios tio;
+  int fd = open(name, O_RDWR | O_NOCTTY);
+
+  if (fd < 0) return -1;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  return fd;
+}
+
+/**
+ * \brief Read what arrives within ms milliseconds, returns the byte count
+ */
+static int readFor(int fd, uint8_t *buf, int size, int ms) {
+  struct timeval tv;
+  fd_set set;
+  int n = 0, got;
+
+  while (n < size) {
+    tv.tv_sec = ms / 1000;
+    tv.tv_usec = (ms % 1000) * 1000;
+    FD_ZERO(&set);
+    FD_SET(fd, &set);
+    if (select(fd + 1, &set, 0, 0, &tv) <= 0) break;
+    if ((got = read(fd, buf + n, size - n)) <= 0) break;
+    n += got;
+  }
+  return n;
+}
+
+static void dump(const char *title, uint8_t status, const uint8_t *data, int count) {
+  printf("%s: status %02X", title, status);
+  for (int i = 0; i < count; i++) printf("%s%02X", (i % 16) ? " " : "\n  ", data[i]);
+  printf("\n");
+}
+
+int main(int argc, char **argv) {
+  static uint8_t reply[4096];
+  uint8_t out[FRAME_MAX + 4], data[256];
+  FrameRequest req;
+  const uint8_t *payload = 0;
+  uint16_t len = 0;
+  bool ok = true;
+  int fd, i, n = 0, size = 0, skip;
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s port [op...]\n", argv[0]);
+    return 2;
+  }
+  for (i = 2; ok && (i < argc); i++) {
+    const char *op = argv[i];
+    if ((strcmp(op, "regs") == 0 || strcmp(op, "sram") == 0) && (i + 2 < argc)) {
+      uint8_t addr = strtoul(argv[i + 1], 0, 0);
+      unsigned long count = strtoul(argv[i + 2], 0, 0);
+      if (count > 255) {
+        fprintf(stderr, "%s: %s reads at most 255 bytes\n", argv[0], op);
+        return 2;
+      }
+      ok = (op[0] == 'r') ? req.readRegs(addr, count) : req.readSRAM(addr, count);
+      i += 2;
+    } else if ((strcmp(op, "setregs") == 0 || strcmp(op, "setsram") == 0) && (i + 1 < argc)) {
+      uint8_t addr = strtoul(argv[i + 1], 0, 0);
+      unsigned count = 0;
+      for (i += 2; (i < argc) && (count <= DATA_MAX) && (sscanf(argv[i], "%2hhx", &data[count]) == 1); i++) count++;
+      i--;
+      ok = (count <= DATA_MAX) &&
+        ((op[3] == 'r') ? req.writeRegs(addr, data, count) : req.writeSRAM(addr, data, count));
+    } else if (strcmp(op, "time") == 0) {
+      ok = req.getTime();
+    } else if ((strcmp(op, "settime") == 0) && (i + 1 < argc)) {
+      ok = req.setTime(strtoul(argv[++i], 0, 0));
+    } else {
+      fprintf(stderr, "%s: bad operation %s\n", argv[0], op);
+      return 2;
+    }
+  }
+  if (!ok) {
+    fprintf(stderr, "%s: more than %d bytes of operations\n", argv[0], FRAME_MAX);
+    return 2;
+  }
+  if (req.ops() == 0) {
+    req.readRegs(0x00, 0x14);
+    req.readSRAM(0x00, 0xEC);
+  }
+
+  if ((fd = openPort(argv[1])) < 0) {
+    perror(argv[1]);
+    return 2;
+  }
+  readFor(fd, reply, sizeof(reply), RESET_WAIT);  // banner
+  size = req.encode(out);
+  if (write(fd, out, size) != size) {
+    perror(argv[1]);
+    return 2;
+  }
+  size = readFor(fd, reply, sizeof(reply), REPLY_WAIT);
+  close(fd);
+
+  // Skip any text ahead of the response frame.
+  for (skip = 0; skip < size; skip++) {
+    if ((reply[skip] == FRAME_SYNC) && ((n = frameDecode(reply + skip, size - skip, &payload, &len)) > 0)) break;
+  }
+  if (n <= 0) {
+    fprintf(stderr, "%s: no response frame in %d bytes\n", argv[0], size);
+    return 1;
+  }
+  if ((len == 1) && (payload[0] == FRAME_REJECT)) {
+    fprintf(stderr, "%s: request rejected\n", argv[0]);
+    return 1;
+  }
+
+  int status = 0;
+  for (i = 0; i < req.ops(); i++) {
+    uint8_t op[3];
+    char title[32];
+    uint8_t s = req.result(payload, len, i, data);
+    req.opAt(i, op);
+    switch (op[0]) {
+      case OP_READ_REGS:
+      case OP_READ_SRAM:
+        snprintf(title, sizeof(title), "%s %02X+%d", (op[0] == OP_READ_REGS) ? "regs" : "sram", op[1], op[2]);
+        dump(title, s, data, op[2]);
+        break;
+      case OP_GET_TIME:
+        printf("time: status %02X, %lu\n", s,
+          (unsigned long)(data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24)));
+        break;
+      default:
+        printf("%s: status %02X\n", (op[0] == OP_SET_TIME) ? "settime" :
+          (op[0] == OP_WRITE_REGS) ? "setregs" : "setsram", s);
+    }
+    if (s != STATUS_OK) status = 1;
+  }
+  return status;
+}
@@ -0,0 +1,70 @@
+/*
+ * Arduino.h - just enough of the Arduino core to build the library on a host
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define DEC 10
+#define HEX 16
+
+// Simulated clock, each call to micros() advances it by SIM_MICROS_STEP
+#define SIM_MICROS_STEP 100
+extern unsigned long simMicros;
+unsigned long micros();
+unsigned long millis();
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void attachInterrupt(int, void (*)(), int) {}
+
+#include "Print.h"
+#include "Stream.h"
+
+/**
+ * HardwareSerial Class
+ * Input is queued with feed(), output collects in out
+ */
+class HardwareSerial : public Stream
+{
+  public:
+    HardwareSerial() : inN(0), inI(0), outN(0), echo(false) {}
+    void begin(long) {}
+    void feed(const uint8_t *buf, size_t size) {
+      while (size-- && (inN < sizeof(in))) in[inN++] = *buf++;
+    }
+    void clear() { inN = inI = outN = 0; }
+    virtual int available() { return inN - inI; }
+    virtual int read() { return (inI < inN) ? in[inI++] : -1; }
+    virtual int peek() { return (inI < inN) ? in[inI] : -1; }
+    virtual void flush() {}
+    virtual size_t write(uint8_t c) {
+      if (outN < sizeof(out)) out[outN++] = c;
+      if (echo) putchar(c);
+      return 1;
+    }
+    using Print::write;
+    uint8_t in[1024];
+    size_t inN, inI;
+    uint8_t out[4096];
+    size_t outN;
+    bool echo;
+};
+
+extern HardwareSerial Serial;
+
+#endif
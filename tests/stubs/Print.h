@@ -0,0 +1,44 @@
+/*
+ * Print.h - host stand-in for the Arduino Print class
+ */
+
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+class Print
+{
+  public:
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size) {
+      size_t n = 0;
+      while (size--) n += write(*buf++);
+      return n;
+    }
+    virtual size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+    size_t print(const char *str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(long v, int base = 10) {
+      char b[24];
+      snprintf(b, sizeof(b), (base == 16) ? "%lX" : "%ld", v);
+      return write(b);
+    }
+    size_t print(int v, int base = 10) { return print((long)v, base); }
+    size_t print(unsigned v, int base = 10) { return print((long)v, base); }
+    size_t print(unsigned long v, int base = 10) { return print((long)v, base); }
+    size_t print(unsigned char v, int base = 10) { return print((long)v, base); }
+    size_t print(double v, int digits = 2) {
+      char b[32];
+      snprintf(b, sizeof(b), "%.*f", digits, v);
+      return write(b);
+    }
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <class T> size_t println(T v, int base) { size_t n = print(v, base); return n + println(); }
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * SPI.h - SPIClass with a simulated DS3234 behind chip select
+ * The first byte of a frame is the address (bit 7 set to write), then the
+ * register pointer auto-increments; 19h reads/writes SRAM at 18h, which
+ * auto-increments too.
+ */
+
+#ifndef SPI_h
+#define SPI_h
+
+#include "Arduino.h"
+
+#define MSBFIRST 1
+#define SPI_MODE1 0x04
+#define SPI_MODE3 0x0C
+
+struct SPISettings {
+  SPISettings() {}
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass
+{
+  public:
+    SPIClass() { reset(); }
+    void reset() {
+      memset(regs, 0, sizeof(regs));
+      memset(sram, 0, sizeof(sram));
+      regs[0x0E] = 0x1C;
+      present = true;
+      state = 0;
+      frames = 0;
+      bytes = 0;
+    }
+    void begin() {}
+    void beginTransaction(SPISettings) { state = 0; frames++; }
+    void endTransaction() {}
+    uint8_t transfer(uint8_t b) {
+      uint8_t r = 0;
+      bytes++;
+      if (!present) return 0xFF;  // MISO pulled up, nothing listens
+      if (state == 0) {
+        writing = (b & 0x80) != 0;
+        ptr = b & 0x7F;
+        state = 1;
+        return 0;
+      }
+      if (ptr == 0x19) {
+        if (writing) sram[regs[0x18]++] = b; else r = sram[regs[0x18]++];
+      } else {
+        if (writing) regs[ptr] = b; else r = regs[ptr];
+        ptr = (ptr + 1) & 0x7F;
+      }
+      return r;
+    }
+
+    uint8_t regs[0x80];
+    uint8_t sram[256];
+    bool present;          // false to simulate a missing chip
+    unsigned long frames;  // chip select cycles
+    unsigned long bytes;
+  private:
+    int state;
+    bool writing;
+    uint8_t ptr;
+};
+
+extern SPIClass SPI;
+
+#endif
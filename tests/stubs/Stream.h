@@ -0,0 +1,28 @@
+/*
+ * Stream.h - host stand-in for the Arduino Stream class
+ */
+
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print
+{
+  public:
+    Stream() : _timeout(1000) {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+    size_t readBytes(uint8_t *buf, size_t size) {
+      size_t n = 0;
+      int c;
+      while ((n < size) && ((c = read()) >= 0)) buf[n++] = c;
+      return n;
+    }
+  protected:
+    unsigned long _timeout;
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * TimeLib.h - the parts of the Arduino Time library the DS3232 library uses,
+ * with the same makeTime()/breakTime() arithmetic
+ */
+
+#ifndef TimeLib_h
+#define TimeLib_h
+
+#include <stdint.h>
+#include <time.h>
+
+typedef struct {
+  uint8_t Second;
+  uint8_t Minute;
+  uint8_t Hour;
+  uint8_t Wday;   // day of week, sunday is day 1
+  uint8_t Day;
+  uint8_t Month;
+  uint8_t Year;   // offset from 1970
+} tmElements_t, TimeElements, *tmElementsPtr_t;
+
+#define tmYearToCalendar(Y) ((Y) + 1970)
+#define CalendarYrToTm(Y)   ((Y) - 1970)
+#define tmYearToY2k(Y)      ((Y) - 30)
+#define y2kYearToTm(Y)      ((Y) + 30)
+
+#define SECS_PER_MIN  ((time_t)(60UL))
+#define SECS_PER_HOUR ((time_t)(3600UL))
+#define SECS_PER_DAY  ((time_t)(SECS_PER_HOUR * 24UL))
+
+#define LEAP_YEAR(Y) (((1970 + (Y)) > 0) && !((1970 + (Y)) % 4) && \
+  (((1970 + (Y)) % 100) || !((1970 + (Y)) % 400)))
+
+static const uint8_t timeLibMonthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+inline void breakTime(time_t timeInput, tmElements_t &tm) {
+  uint8_t year, month, monthLength;
+  uint32_t time = (uint32_t)timeInput;
+  unsigned long days;
+
+  tm.Second = time % 60;
+  time /= 60;
+  tm.Minute = time % 60;
+  time /= 60;
+  tm.Hour = time % 24;
+  time /= 24;
+  tm.Wday = ((time + 4) % 7) + 1;
+
+  year = 0;
+  days = 0;
+  while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) year++;
+  tm.Year = year;
+  days -= LEAP_YEAR(year) ? 366 : 365;
+  time -= days;
+
+  for (month = 0; month < 12; month++) {
+    monthLength = ((month == 1) && LEAP_YEAR(year)) ? 29 : timeLibMonthDays[month];
+    if (time < monthLength) break;
+    time -= monthLength;
+  }
+  tm.Month = month + 1;
+  tm.Day = time + 1;
+}
+
+inline time_t makeTime(const tmElements_t &tm) {
+  uint32_t seconds;
+  int i;
+
+  seconds = tm.Year * (SECS_PER_DAY * 365);
+  for (i = 0; i < tm.Year; i++) {
+    if (LEAP_YEAR(i)) seconds += SECS_PER_DAY;
+  }
+  for (i = 1; i < tm.Month; i++) {
+    if ((i == 2) && LEAP_YEAR(tm.Year)) {
+      seconds += SECS_PER_DAY * 29;
+    } else {
+      seconds += SECS_PER_DAY * timeLibMonthDays[i - 1];
+    }
+  }
+  seconds += (tm.Day - 1) * SECS_PER_DAY;
+  seconds += tm.Hour * SECS_PER_HOUR;
+  seconds += tm.Minute * SECS_PER_MIN;
+  seconds += tm.Second;
+  return (time_t)seconds;
+}
+
+#endif
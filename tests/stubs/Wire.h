@@ -0,0 +1,82 @@
+/*
+ * Wire.h - TwoWire with a simulated DS3232 behind it
+ * The register file auto-increments like the chip; transfers stop at the
+ * 32 byte Wire buffer.
+ */
+
+#ifndef Wire_h
+#define Wire_h
+
+#include "Arduino.h"
+
+#define SIM_WIRE_BUFFER 32
+
+class TwoWire : public Stream
+{
+  public:
+    TwoWire(uint8_t address = 0x68) { reset(address); }
+    void reset(uint8_t address = 0x68) {
+      memset(regs, 0, sizeof(regs));
+      regs[0x0E] = 0x1C;  // Control power-on value
+      this->address = address;
+      present = true;
+      ptr = 0;
+      txn = rxn = rxi = 0;
+      begins = 0;
+      transactions = 0;
+      bytes = 0;
+    }
+    void begin() { begins++; }
+    void beginTransmission(int addr) { txAddr = addr; txn = 0; }
+    virtual size_t write(uint8_t b) {
+      if (txn > SIM_WIRE_BUFFER) return 0;
+      tx[txn++] = b;
+      return 1;
+    }
+    using Print::write;
+    size_t write(int b) { return write((uint8_t)b); }
+    size_t write(unsigned b) { return write((uint8_t)b); }
+    size_t write(long b) { return write((uint8_t)b); }
+    size_t write(unsigned long b) { return write((uint8_t)b); }
+    uint8_t endTransmission(bool = true) {
+      int i;
+      transactions++;
+      if (!present || (txAddr != address)) return 2;  // NACK on address
+      if (txn > 0) {
+        ptr = tx[0];
+        for (i = 1; i < txn; i++) regs[ptr++] = tx[i];
+        bytes += txn;
+      }
+      return 0;
+    }
+    uint8_t requestFrom(int addr, int size) {
+      transactions++;
+      rxn = rxi = 0;
+      if (!present || (addr != address)) return 0;
+      while ((rxn < size) && (rxn < SIM_WIRE_BUFFER)) rx[rxn++] = regs[ptr++];
+      bytes += rxn;
+      return rxn;
+    }
+    virtual int available() { return rxn - rxi; }
+    virtual int read() { return (rxi < rxn) ? rx[rxi++] : -1; }
+    virtual int peek() { return (rxi < rxn) ? rx[rxi] : -1; }
+    virtual void flush() {}
+
+    uint8_t regs[256];    // 00h~13h registers, 14h~FFh SRAM
+    uint8_t address;
+    bool present;         // false to simulate a missing chip
+    int begins;
+    unsigned long transactions;
+    unsigned long bytes;
+  private:
+    uint8_t ptr;
+    int txAddr;
+    uint8_t tx[SIM_WIRE_BUFFER + 1];
+    int txn;
+    uint8_t rx[SIM_WIRE_BUFFER];
+    int rxn, rxi;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ * avr/pgmspace.h - flash is ordinary memory on a host
+ */
+
+#ifndef pgmspace_h
+#define pgmspace_h
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(p))
+#define pgm_read_ptr(p) (*(void * const *)(p))
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * stubs.cpp - the global objects of the host stand-ins
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+
+unsigned long simMicros = 0;
+
+unsigned long micros() {
+  return simMicros += SIM_MICROS_STEP;
+}
+
+unsigned long millis() {
+  return simMicros / 1000;
+}
+
+TwoWire Wire;
+SPIClass SPI;
+HardwareSerial Serial;
@@ -0,0 +1,118 @@
+/*
+ * test_decode.cpp - batch decoding against the single block path and Time.h
+ * ds3232DecodeTimes() takes the SSE2 or AVX2 path on x86 hosts (see
+ * DS3232_LANES); every lane count and remainder must give the same bits
+ * as ds3232DecodeTime() and, for valid months, as makeTime() of
+ * DS3232RTC::decodeTime().
+ */
+
+#include <stdlib.h>
+#include "DS3232RTC.h"
+#include "DS3232Decode.h"
+#include "check.h"
+
+#define BATCH 1024
+
+#if defined(DS3232_NO_SIMD)
+#define DECODE_PATH "scalar"
+#elif defined(__AVX2__)
+#define DECODE_PATH "avx2"
+#elif defined(__SSE2__)
+#define DECODE_PATH "sse2"
+#else
+#define DECODE_PATH "scalar"
+#endif
+
+static uint8_t blocks[BATCH * DS3232_TIME_BLOCK];
+static uint32_t out[BATCH + 1];
+
+/**
+ * \brief Decode the first count blocks and compare them one by one
+ */
+static void compare(size_t count) {
+  tmElements_t tm;
+  size_t i;
+
+  out[count] = 0xA5A5A5A5;
+  ds3232DecodeTimes(blocks, count, out);
+  CHECK_EQ(out[count], 0xA5A5A5A5);  // nothing written past the end
+  for (i = 0; i < count; i++) {
+    const uint8_t *b = blocks + i * DS3232_TIME_BLOCK;
+    CHECK_EQ(out[i], ds3232DecodeTime(b));
+    DS3232RTC::decodeTime(b, tm);
+    if ((tm.Month >= 1) && (tm.Month <= 12)) {
+      CHECK_EQ(out[i], (uint32_t)makeTime(tm));
+    }
+  }
+}
+
+int main() {
+  unsigned i, round, reg5, reg6;
+  uint8_t *b;
+
+  srand(7);
+
+  // Random bytes, every batch length up to a few steps of 8 lanes
+  for (round = 0; round < 200; round++) {
+    for (i = 0; i < sizeof(blocks); i++) blocks[i] = rand();
+    for (i = 0; i <= 40; i++) compare(i);
+    compare(BATCH - 1);
+  }
+
+  // Every month and year register pair, with each date, hour form and
+  // random seconds and minutes
+  for (reg5 = 0; reg5 < 256; reg5++) {
+    for (reg6 = 0; reg6 < 256; reg6++) {
+      for (i = 0; i < 64; i++) {
+        b = blocks + i * DS3232_TIME_BLOCK;
+        b[0] = rand();
+        b[1] = rand();
+        b[2] = (i & 1) ? (rand() & 0x7F) : (rand() & 0x3F);
+        b[3] = rand();
+        b[4] = i;
+        b[5] = reg5;
+        b[6] = reg6;
+      }
+      compare(64);
+    }
+  }
+
+  // The range the RTC holds, in valid BCD, for whole days either side
+  // of the leap and century boundaries
+  static const uint32_t edges[] = {
+    946684800UL,   // 2000-01-01
+    951782400UL,   // 2000-02-29
+    4107542400UL,  // 2100-03-01
+    4294967295UL   // 2106-02-07
+  };
+  for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+    tmElements_t tm;
+    unsigned k;
+    for (k = 0; k < BATCH; k++) {
+      breakTime(edges[i] - BATCH / 2 * 3607UL + k * 3607UL, tm);
+      DS3232RTC::encodeTime(tm, blocks + k * DS3232_TIME_BLOCK);
+    }
+    compare(BATCH);
+  }
+
+  // Alarm blocks, batched against RTC.readAlarm() from the registers
+  alarmElements_t alarms[2];
+  for (round = 0; round < 100000; round++) {
+    for (i = 0; i < DS3232_ALARM_BLOCK; i++) Wire.regs[0x07 + i] = rand();
+    ds3232DecodeAlarms(Wire.regs + 0x07, 1, alarms);
+    for (i = 0; i < 2; i++) {
+      alarmMode_t mode;
+      tmElements_t tm;
+      memset(&tm, 0, sizeof(tm));
+      RTC.readAlarm(i + 1, mode, tm);
+      CHECK_EQ(alarms[i].Mode, mode);
+      CHECK_EQ(alarms[i].Second, tm.Second);
+      CHECK_EQ(alarms[i].Minute, tm.Minute);
+      CHECK_EQ(alarms[i].Hour, tm.Hour);
+      CHECK_EQ(alarms[i].Day, tm.Day);
+      CHECK_EQ(alarms[i].Wday, tm.Wday);
+    }
+  }
+
+  return checkDone("test_decode (" DECODE_PATH ")");
+}
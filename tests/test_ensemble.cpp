@@ -0,0 +1,166 @@
+/*
+ * test_ensemble.cpp - DS3232Ensemble over several simulated DS3232 buses
+ */
+
+#include "DS3232Ensemble.h"
+#include "DS3232Regs.h"
+#include "check.h"
+
+#define T0 1700000000UL
+
+static TwoWire wire[4];
+
+static void setChip(uint8_t chip, time_t t, uint8_t stat = 0x08) {
+  tmElements_t tm;
+  breakTime(t, tm);
+  DS3232RTC::encodeTime(tm, wire[chip].regs);
+  wire[chip].regs[0x0F] = stat;
+}
+
+static time_t chipTime(uint8_t chip) {
+  tmElements_t tm;
+  DS3232RTC::decodeTime(wire[chip].regs, tm);
+  return makeTime(tm);
+}
+
+int main() {
+  DS3232Wire bus0(wire[0]), bus1(wire[1]), bus2(wire[2]), bus3(wire[3]);
+  DS3232Wire *bus[4] = { &bus0, &bus1, &bus2, &bus3 };
+  unsigned long tx;
+  uint8_t i;
+
+  // add() starts each bus
+  {
+    DS3232Ensemble e;
+    for (i = 0; i < 4; i++) {
+      CHECK(e.add(*bus[i]));
+      CHECK_EQ(wire[i].begins, 1);
+    }
+    CHECK(!e.add(bus0));
+    CHECK_EQ(e.count(), 4);
+  }
+
+  // Three chips, one 100 s off: one burst per chip, the outlier flagged
+  {
+    DS3232Ensemble e;
+    for (i = 0; i < 3; i++) e.add(*bus[i]);
+    setChip(0, T0);
+    setChip(1, T0 + 1, 0x09);
+    setChip(2, T0 + 100);
+    tx = wire[0].transactions;
+    CHECK_EQ(e.read(), T0 + 1);
+    CHECK_EQ(wire[0].transactions - tx, 2);  // address, then the 16 byte read
+    CHECK_EQ(e.status(0), DS3232ENSEMBLE_OK);
+    CHECK_EQ(e.status(1), DS3232ENSEMBLE_OK);
+    CHECK_EQ(e.status(2), DS3232ENSEMBLE_DRIFT);
+    CHECK_EQ(e.time(2), T0 + 100);
+
+    // Flagging is all read() does, the chip is set by resync()
+    CHECK_EQ(chipTime(2), T0 + 100);
+    CHECK_EQ(e.resync(), 1);
+    CHECK_EQ(chipTime(2), T0 + 1);
+    CHECK_EQ(wire[0].regs[0x06], 0x23);
+    CHECK_EQ(e.read(), T0 + 1);
+    CHECK_EQ(e.status(2), DS3232ENSEMBLE_OK);
+
+    // OSF is distrusted, resynced and cleared, alarm flags kept
+    wire[1].regs[0x0F] |= DS3232_OSF;
+    CHECK_EQ(e.read(), T0);  // midpoint of T0 and T0 + 1
+    CHECK_EQ(e.status(1), DS3232ENSEMBLE_OSF);
+    CHECK_EQ(e.resync(), 1);
+    CHECK_EQ(wire[1].regs[0x0F], 0x08 | DS3232_A1F | DS3232_A2F);  // flags written as 1, which the chip ignores
+    CHECK_EQ(e.read(), T0);
+    CHECK_EQ(e.status(1), DS3232ENSEMBLE_OK);
+
+    // A missing chip
+    wire[2].present = false;
+    CHECK_EQ(e.read(), T0);
+    CHECK_EQ(e.status(2), DS3232ENSEMBLE_NOREPLY);
+    CHECK_EQ(e.resync(), 0);
+    wire[2].present = true;
+  }
+
+  // Two chips that disagree: both flagged, neither rewritten to the midpoint
+  {
+    DS3232Ensemble e;
+    e.add(bus0);
+    e.add(bus1);
+    setChip(0, T0);
+    setChip(1, T0 + 100);
+    CHECK_EQ(e.read(), 0);
+    CHECK_EQ(e.status(0), DS3232ENSEMBLE_DRIFT);
+    CHECK_EQ(e.status(1), DS3232ENSEMBLE_DRIFT);
+    CHECK_EQ(e.resync(), 0);
+    CHECK_EQ(chipTime(0), T0);
+    CHECK_EQ(chipTime(1), T0 + 100);
+
+    // Within the threshold they agree
+    setChip(1, T0 + 1);
+    CHECK_EQ(e.read(), T0);
+    CHECK_EQ(e.status(0), DS3232ENSEMBLE_OK);
+    CHECK_EQ(e.status(1), DS3232ENSEMBLE_OK);
+
+    // One of two stopped, the other is trusted on its own
+    setChip(1, T0 + 100, 0x88);
+    CHECK_EQ(e.read(), T0);
+    CHECK_EQ(e.status(1), DS3232ENSEMBLE_OSF);
+    CHECK_EQ(e.resync(), 1);
+    CHECK_EQ(chipTime(1), T0);
+  }
+
+  // Four chips split two and two: no majority
+  {
+    DS3232Ensemble e;
+    for (i = 0; i < 4; i++) e.add(*bus[i]);
+    setChip(0, T0);
+    setChip(1, T0 + 1);
+    setChip(2, T0 + 100);
+    setChip(3, T0 + 100);
+    CHECK_EQ(e.read(), 0);
+    CHECK_EQ(e.resync(), 0);
+    CHECK_EQ(chipTime(2), T0 + 100);
+
+    // Three against one: the one is an outlier
+    setChip(2, T0 + 2);
+    CHECK_EQ(e.read(), T0 + 1);
+    CHECK_EQ(e.status(3), DS3232ENSEMBLE_DRIFT);
+    CHECK_EQ(e.resync(), 1);
+    CHECK_EQ(chipTime(3), T0 + 1);
+    CHECK_EQ(chipTime(0), T0);
+  }
+
+  // Time passing between read() and resync() is carried over
+  {
+    DS3232Ensemble e;
+    for (i = 0; i < 3; i++) e.add(*bus[i]);
+    setChip(0, T0);
+    setChip(1, T0);
+    setChip(2, T0 + 100);
+    CHECK_EQ(e.read(), T0);
+    simMicros += 5500000UL;  // 5.5 s, the chips stand still in the simulator
+    CHECK_EQ(e.resync(), 1);
+    CHECK_EQ(chipTime(2), T0 + 5);
+    CHECK_EQ(e.time(2), T0 + 5);
+  }
+
+  // autoResync corrects the outlier inside read()
+  {
+    DS3232Ensemble e(2, true);
+    for (i = 0; i < 3; i++) e.add(*bus[i]);
+    setChip(0, T0);
+    setChip(1, T0 + 1);
+    setChip(2, T0 - 300);
+    CHECK_EQ(e.read(), T0);
+    CHECK_EQ(chipTime(2), T0);
+    CHECK_EQ(e.status(2), DS3232ENSEMBLE_OK);
+
+    // but not without a majority
+    setChip(1, T0 + 100);
+    setChip(2, T0 + 200);
+    CHECK_EQ(e.read(), 0);
+    CHECK_EQ(chipTime(1), T0 + 100);
+    CHECK_EQ(chipTime(2), T0 + 200);
+  }
+
+  return checkDone("test_ensemble");
+}
@@ -0,0 +1,91 @@
+/*
+ * test_format.cpp - ISO 8601 and alarm descriptor round trips
+ */
+
+#include "DS3232Format.h"
+#include "check.h"
+
+/**
+ * \brief Every 7th hour from 2000 to the end of a 32 bit time_t (2106) formats
+ * and parses back to the same time
+ */
+static void testISO8601() {
+  tmElements_t tm, back;
+  char buf[DS3232_ISO8601_LEN + 1];
+  uint32_t t;
+
+  for (t = 946684800UL; t < 0xFFFF0000UL; t += 7 * SECS_PER_HOUR + 13) {
+    breakTime(t, tm);
+    CHECK_EQ(formatISO8601(buf, tm), DS3232_ISO8601_LEN);
+    CHECK_EQ(strlen(buf), DS3232_ISO8601_LEN);
+    CHECK(parseISO8601(buf, back));
+    CHECK_EQ(makeTime(back), t);
+    CHECK_EQ(back.Wday, tm.Wday);
+  }
+
+  CHECK(parseISO8601("2020-02-29 23:59:59", back));
+  CHECK(parseISO8601("2000-01-01T00:00:00", back));
+  CHECK(parseISO8601("2199-12-31T23:59:59", back));
+  CHECK(!parseISO8601("1999-12-31T23:59:59", back));  // the RTC can't hold these
+  CHECK(!parseISO8601("2200-01-01T00:00:00", back));
+  CHECK(!parseISO8601("2100-02-29T00:00:00", back));
+  CHECK(!parseISO8601("2021-02-29T00:00:00", back));
+  CHECK(!parseISO8601("2021-04-31T00:00:00", back));
+  CHECK(!parseISO8601("2021-13-01T00:00:00", back));
+  CHECK(!parseISO8601("2021-01-01T24:00:00", back));
+  CHECK(!parseISO8601("2021-01-01T00:60:00", back));
+  CHECK(!parseISO8601("2021-01-01X00:00:00", back));
+  CHECK(!parseISO8601("2021-01-0", back));
+  CHECK(!parseISO8601("2021-0a-01T00:00:00", back));
+}
+
+/**
+ * \brief Each settable mode formats and parses back
+ */
+static void testAlarm() {
+  static const struct {
+    alarmMode_t mode;
+    const char *text;
+  } cases[] = {
+    { alarmModePerSecond,    "***T**:**:**" },
+    { alarmModePerMinute,    "***T**:**:00" },
+    { alarmModeSecondsMatch, "***T**:**:05" },
+    { alarmModeMinutesMatch, "***T**:06:05" },
+    { alarmModeHoursMatch,   "***T07:06:05" },
+    { alarmModeDateMatch,    "D08T07:06:05" },
+    { alarmModeDayMatch,     "W03T07:06:05" },
+    { alarmModeOff,          "OFFT--:--:--" },
+    { alarmModeUnknown,      "???T??:??:??" }
+  };
+  char buf[DS3232_ALARM_LEN + 1];
+  tmElements_t tm, back;
+  alarmMode_t mode;
+  uint8_t i;
+
+  memset(&tm, 0, sizeof(tm));
+  tm.Second = 5;
+  tm.Minute = 6;
+  tm.Hour = 7;
+  tm.Day = 8;
+  tm.Wday = 3;
+  for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    CHECK_EQ(formatAlarm(buf, cases[i].mode, tm), DS3232_ALARM_LEN);
+    CHECK(strcmp(buf, cases[i].text) == 0);
+    if (cases[i].mode == alarmModeUnknown) {
+      CHECK(!parseAlarm(buf, mode, back));
+      continue;
+    }
+    CHECK(parseAlarm(buf, mode, back));
+    CHECK_EQ(mode, (cases[i].mode == alarmModePerMinute) ? alarmModeSecondsMatch : cases[i].mode);
+  }
+  CHECK(!parseAlarm("***T12:**:00", mode, back));  // fields must match from the seconds up
+  CHECK(!parseAlarm("D32T00:00:00", mode, back));
+  CHECK(!parseAlarm("W08T00:00:00", mode, back));
+  CHECK(!parseAlarm("***T24:00:00", mode, back));
+}
+
+int main() {
+  testISO8601();
+  testAlarm();
+  return checkDone("test_format");
+}
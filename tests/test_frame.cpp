@@ -0,0 +1,139 @@
+/*
+ * test_frame.cpp - the TestRTC binary protocol over a loopback Serial
+ * The sketch is built from build/TestRTC.cpp (see ino2cpp.sh) and talks
+ * to the simulated DS3232 on Wire; requests come from frame.h.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "frame.h"
+#include "check.h"
+
+void setup();
+void loop();
+
+static const uint8_t *payload;
+static uint16_t len;
+
+/**
+ * \brief Feed a frame to the sketch and decode its answer
+ */
+static bool exchange(const uint8_t *buf, uint16_t size) {
+  Serial.clear();
+  Serial.feed(buf, size);
+  while (Serial.available()) loop();
+  return frameDecode(Serial.out, Serial.outN, &payload, &len) == (int)Serial.outN;
+}
+
+static bool exchange(const FrameRequest &req) {
+  uint8_t buf[FRAME_MAX + 4];
+  return exchange(buf, req.encode(buf));
+}
+
+static uint32_t le32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int main() {
+  uint8_t data[256], hello[] = { 'h', 'i', '!' };
+  FrameRequest req;
+  int i;
+
+  setup();
+
+  // A full readout batch with a time set and an SRAM write ahead of it
+  req.setTime(1700000000UL);
+  req.writeSRAM(0x10, hello, sizeof(hello));
+  req.readRegs(0x00, 0x14);
+  req.readSRAM(0x00, 0xEC);
+  req.getTime();
+  CHECK(exchange(req));
+  CHECK_EQ(len, req.responseSize());
+  CHECK_EQ(len, 1 + 1 + (20 + 2) + (236 + 15) + 5);
+  CHECK_EQ(req.result(payload, len, 0), STATUS_OK);
+  CHECK_EQ(req.result(payload, len, 1), STATUS_OK);
+  CHECK_EQ(req.result(payload, len, 2, data), STATUS_OK);
+  CHECK(memcmp(data, Wire.regs, 0x14) == 0);
+  CHECK_EQ(data[0x06], 0x23);  // 2023
+  CHECK_EQ(req.result(payload, len, 3, data), STATUS_OK);
+  CHECK(memcmp(data, Wire.regs + 0x14, 0xEC) == 0);
+  CHECK(memcmp(data + 0x10, hello, sizeof(hello)) == 0);
+  CHECK_EQ(req.result(payload, len, 4, data), STATUS_OK);
+  CHECK_EQ(le32(data), 1700000000UL);
+
+  // Every read chunk has its own status, a failure after the first
+  // chunk isn't reported as ok.  SRAM ends at 0xEC, inside the 2nd chunk.
+  req.clear();
+  req.readSRAM(0xD0, 32);
+  req.readSRAM(0xD0, 16);
+  CHECK(exchange(req));
+  CHECK_EQ(len, 34 + 17);
+  CHECK_EQ(payload[0], STATUS_OK);
+  CHECK_EQ(payload[17], STATUS_BUS);
+  CHECK_EQ(payload[17 + 1 + 12], 0x00);  // zero filled
+  CHECK_EQ(req.result(payload, len, 0, data), STATUS_BUS);
+  CHECK(memcmp(data, Wire.regs + 0x14 + 0xD0, 16) == 0);
+  CHECK_EQ(req.result(payload, len, 1), STATUS_OK);
+
+  // A missing chip fails every chunk, and the time with zeros
+  Wire.present = false;
+  req.clear();
+  req.readRegs(0x00, 0x20);
+  req.getTime();
+  CHECK(exchange(req));
+  CHECK_EQ(payload[0], STATUS_BUS);
+  CHECK_EQ(payload[17], STATUS_BUS);
+  memset(data, 0xFF, 4);
+  CHECK_EQ(req.result(payload, len, 1, data), STATUS_BUS);
+  CHECK_EQ(le32(data), 0);
+  Wire.present = true;
+
+  // An empty read still answers its status
+  req.clear();
+  req.readRegs(0x00, 0);
+  CHECK(exchange(req));
+  CHECK_EQ(len, 1);
+  CHECK_EQ(payload[0], STATUS_OK);
+
+  // Times the RTC can't hold are refused and leave the clock alone
+  static const uint32_t before2000[] = { 0UL, 1UL, 915148800UL, 946684799UL };
+  for (i = 0; i < (int)(sizeof(before2000) / sizeof(before2000[0])); i++) {
+    req.clear();
+    req.setTime(before2000[i]);
+    req.getTime();
+    CHECK(exchange(req));
+    CHECK_EQ(req.result(payload, len, 0), STATUS_RANGE);
+    CHECK_EQ(req.result(payload, len, 1, data), STATUS_OK);
+    CHECK(le32(data) >= 1700000000UL);
+  }
+  req.clear();
+  req.setTime(946684800UL);  // 2000-01-01
+  req.setTime(4294967295UL);  // 2106-02-07, last 32 bit time_t
+  req.getTime();
+  CHECK(exchange(req));
+  CHECK_EQ(req.result(payload, len, 0), STATUS_OK);
+  CHECK_EQ(req.result(payload, len, 1), STATUS_OK);
+  CHECK_EQ(req.result(payload, len, 2, data), STATUS_OK);
+  CHECK_EQ(le32(data), 4294967295UL);
+  CHECK_EQ(Wire.regs[0x05] & 0x80, 0x80);  // century
+
+  // Bad CRC and malformed batches are rejected
+  uint8_t buf[FRAME_MAX + 4];
+  req.clear();
+  req.getTime();
+  uint16_t size = req.encode(buf);
+  buf[size - 1] ^= 0x01;
+  CHECK(exchange(buf, size));
+  CHECK_EQ(len, 1);
+  CHECK_EQ(payload[0], FRAME_REJECT);
+  const uint8_t truncated[] = { FRAME_SYNC, 0x02, 0x00, OP_READ_REGS, 0x00, 0x00 };
+  uint8_t crc = 0;
+  memcpy(buf, truncated, sizeof(truncated));
+  for (i = 1; i < 5; i++) crc = frameCrc8(crc, buf[i]);
+  buf[5] = crc;
+  CHECK(exchange(buf, sizeof(truncated)));
+  CHECK_EQ(len, 1);
+  CHECK_EQ(payload[0], FRAME_REJECT);
+
+  return checkDone("test_frame");
+}
@@ -0,0 +1,92 @@
+/*
+ * test_log.cpp - DS3232Log codec and SRAM round trips on the simulated DS3232
+ */
+
+#include <stdlib.h>
+#include "DS3232Log.h"
+#include "check.h"
+
+/**
+ * \brief Every code width, deltas around each varint length boundary
+ */
+static void testCodec() {
+  static const uint32_t deltas[] = {
+    0, 1, 7, 8, 15, 16, 127, 128, 1023, 1024, 16383, 16384,
+    131071, 131072, 2097151, 2097152, 0x0FFFFFFFUL, 0x1FFFFFFFUL
+  };
+  uint8_t buf[DS3232LOG_MAX_VARINT];
+  uint8_t bits, i, n, code;
+  uint32_t delta;
+
+  for (bits = 1; bits <= 7; bits++) {
+    for (i = 0; i < sizeof(deltas) / sizeof(deltas[0]); i++) {
+      if (deltas[i] > (0xFFFFFFFFUL >> bits)) {
+        CHECK_EQ(DS3232Log::encode(buf, deltas[i], 1, bits), 0);
+        continue;
+      }
+      n = DS3232Log::encode(buf, deltas[i], (1 << bits) - 1, bits);
+      CHECK(n >= 1 && n <= DS3232LOG_MAX_VARINT);
+      CHECK_EQ(DS3232Log::decode(buf, n, delta, code, bits), n);
+      CHECK_EQ(delta, deltas[i]);
+      CHECK_EQ(code, (1 << bits) - 1);
+      CHECK_EQ(DS3232Log::decode(buf, n - 1, delta, code, bits), 0);  // truncated
+    }
+  }
+  // 4 code bits: 1 byte up to 7 s, 2 bytes up to 1023 s, 3 bytes up to 131071 s
+  CHECK_EQ(DS3232Log::encode(buf, 7, 0, 4), 1);
+  CHECK_EQ(DS3232Log::encode(buf, 8, 0, 4), 2);
+  CHECK_EQ(DS3232Log::encode(buf, 1023, 0, 4), 2);
+  CHECK_EQ(DS3232Log::encode(buf, 1024, 0, 4), 3);
+  CHECK_EQ(DS3232Log::encode(buf, 131071, 0, 4), 3);
+}
+
+/**
+ * \brief Fill a log, reopen it and read every event back
+ */
+static void testRoundTrip() {
+  time_t t = 1700000000, times[256], rt;
+  uint8_t codes[256], code;
+  int n = 0, k = 0;
+
+  Wire.reset();
+  DS3232Log log(10, 100, 4);
+  CHECK(log.begin(t));
+  CHECK_EQ(log.used(), 0);
+  CHECK_EQ(log.remaining(), 100 - DS3232LOG_HEADER);
+  srand(1);
+  for (;;) {
+    time_t next = t + rand() % 2000;
+    if (!log.append(next, n & 15)) break;
+    t = next;
+    times[n] = t;
+    codes[n] = n & 15;
+    n++;
+  }
+  CHECK(n > 0);
+  CHECK(log.remaining() < DS3232LOG_MAX_VARINT);
+  CHECK(!log.append(t - 1, 0));  // earlier than the last event
+
+  DS3232Log again(10, 100, 4);
+  CHECK(again.open());
+  CHECK_EQ(again.used(), log.used());
+  CHECK_EQ(again.last(), t);
+  while (again.next(rt, code)) {
+    CHECK_EQ(rt, times[k]);
+    CHECK_EQ(code, codes[k]);
+    k++;
+  }
+  CHECK_EQ(k, n);
+
+  // SRAM outside the log is untouched
+  CHECK_EQ(Wire.regs[0x14 + 9], 0);
+  CHECK_EQ(Wire.regs[0x14 + 110], 0);
+
+  DS3232Log other(10, 100, 5);  // code width differs from the stored one
+  CHECK(!other.open());
+}
+
+int main() {
+  testCodec();
+  testRoundTrip();
+  return checkDone("test_log");
+}
@@ -0,0 +1,123 @@
+/*
+ * test_plan.cpp - DS3232AlarmPlan against the one register at a time API
+ */
+
+#include "DS3232RTC.h"
+#include "DS3232Regs.h"
+#include "check.h"
+
+static uint8_t start[256];
+
+static void restart(uint8_t control, uint8_t status) {
+  int i;
+  for (i = 0; i < 256; i++) Wire.regs[i] = 0x55 + i;
+  Wire.regs[0x0E] = control;
+  Wire.regs[0x0F] = status;
+  memcpy(start, Wire.regs, sizeof(start));
+}
+
+int main() {
+  static const uint8_t controls[] = { 0x1C, 0x9C, 0xC5, 0xE0, 0x20, 0x00 };
+  uint8_t ref[256];
+  tmElements_t t1, t2;
+  unsigned long tx;
+  unsigned i;
+
+  memset(&t1, 0, sizeof(t1));
+  memset(&t2, 0, sizeof(t2));
+  t1.Second = 5;
+  t1.Minute = 30;
+  t1.Hour = 6;
+  t2.Minute = 15;
+  t2.Hour = 22;
+  t2.Wday = 3;
+  RTC.begin();
+
+  for (i = 0; i < sizeof(controls); i++) {
+    // What the sequential calls leave behind
+    restart(controls[i], 0x8B);  // OSF, EN32kHz, both alarm flags
+    RTC.writeAlarm(1, alarmModeHoursMatch, t1);
+    RTC.writeAlarm(2, alarmModeDayMatch, t2);
+    RTC.setSQIMode(sqiModeAlarmBoth);
+    RTC.clearAlarmFlag(3);
+    memcpy(ref, Wire.regs, sizeof(ref));
+    CHECK_EQ(ref[0x0E], (controls[i] & 0xE0) | DS3232_INTCN | DS3232_A1IE | DS3232_A2IE);
+
+    // Loaded: one read, one write
+    restart(controls[i], 0x8B);
+    {
+      DS3232AlarmPlan p;
+      tx = Wire.transactions;
+      CHECK(p.load());
+      CHECK_EQ(Wire.transactions - tx, 2);
+      p.writeAlarm(1, alarmModeHoursMatch, t1)
+        .writeAlarm(2, alarmModeDayMatch, t2)
+        .setSQIMode(sqiModeAlarmBoth)
+        .clearAlarmFlag(3);
+      tx = Wire.transactions;
+      CHECK(p.commit());
+      CHECK_EQ(Wire.transactions - tx, 1);
+      CHECK(memcmp(ref, Wire.regs, sizeof(ref)) == 0);
+    }
+
+    // Without load() Control is read back, EOSC, BBSQW and CONV kept
+    restart(controls[i], 0x8B);
+    {
+      DS3232AlarmPlan p;
+      p.writeAlarm(1, alarmModeHoursMatch, t1)
+        .writeAlarm(2, alarmModeDayMatch, t2)
+        .setSQIMode(sqiModeAlarmBoth)
+        .clearAlarmFlag(3);
+      tx = Wire.transactions;
+      CHECK(p.commit());
+      CHECK_EQ(Wire.transactions - tx, 3);  // address, read, write
+      CHECK(memcmp(ref, Wire.regs, sizeof(ref)) == 0);
+    }
+
+    // Without load() the alarms alone are a single write
+    restart(controls[i], 0x8B);
+    {
+      DS3232AlarmPlan p;
+      p.writeAlarm(1, alarmModeHoursMatch, t1)
+        .writeAlarm(2, alarmModeDayMatch, t2);
+      tx = Wire.transactions;
+      CHECK(p.commit());
+      CHECK_EQ(Wire.transactions - tx, 1);
+      CHECK(memcmp(ref + 0x07, Wire.regs + 0x07, 7) == 0);
+      CHECK_EQ(Wire.regs[0x0E], controls[i]);
+      CHECK_EQ(Wire.regs[0x0F], 0x8B);
+    }
+  }
+
+  // The reported case: 0xC5 keeps BBSQW when only the SQI mode changes
+  restart(0xC5, 0x88);
+  {
+    DS3232AlarmPlan p;
+    p.setSQIMode(sqiModeAlarmBoth);
+    CHECK(p.commit());
+    CHECK_EQ(Wire.regs[0x0E], 0xC7);
+    p.setSQIMode(sqiMode1Hz);
+    CHECK(p.commit());
+    CHECK_EQ(Wire.regs[0x0E], 0xC0);
+  }
+
+  // A gap between changes is read back, the flag clear keeps OSF
+  restart(0x1C, 0x8B);
+  {
+    DS3232AlarmPlan p;
+    p.writeAlarm(1, alarmModeHoursMatch, t1).clearAlarmFlag(1);
+    CHECK(p.commit());
+    CHECK(memcmp(start + 0x0B, Wire.regs + 0x0B, 4) == 0);
+    CHECK_EQ(Wire.regs[0x0F], 0x8A);
+  }
+
+  // Nothing to write, no bus traffic
+  {
+    DS3232AlarmPlan p;
+    tx = Wire.transactions;
+    CHECK(p.commit());
+    CHECK_EQ(Wire.transactions, tx);
+  }
+
+  return checkDone("test_plan");
+}
@@ -0,0 +1,118 @@
+/*
+ * test_spi.cpp - DS3232RTC and DS3232SRAM over DS3234SPI on the simulated DS3234
+ */
+
+#include "DS3234SPI.h"
+#include "check.h"
+
+static DS3234SPI spiBus(10);
+
+/**
+ * \brief Time, alarms and control go to the same registers as on Wire
+ */
+static void testRegisters() {
+  tmElements_t tm, back;
+  alarmMode_t mode;
+  unsigned long frames;
+
+  SPI.reset();
+  breakTime(1700000000UL, tm);
+  frames = SPI.frames;
+  RTC.write(tm);
+  CHECK_EQ(SPI.regs[0x00], 0x20);  // 22:13:20, BCD
+  CHECK_EQ(SPI.regs[0x01], 0x13);
+  CHECK_EQ(SPI.regs[0x02], 0x22);
+  CHECK_EQ(SPI.regs[0x05], 0x11);  // November 2023
+  CHECK_EQ(SPI.regs[0x06], 0x23);
+  RTC.read(back);
+  CHECK_EQ(makeTime(back), 1700000000UL);
+  CHECK_EQ(RTC.get(), 1700000000UL);
+  RTC.set(4200000000UL);  // 2103-02-03, century bit in the month
+  CHECK_EQ(SPI.regs[0x05], 0x82);
+  CHECK_EQ(SPI.regs[0x06], 0x03);
+  CHECK_EQ(RTC.get(), 4200000000UL);
+
+  memset(&tm, 0, sizeof(tm));
+  tm.Hour = 6;
+  tm.Minute = 30;
+  RTC.writeAlarm(2, alarmModeHoursMatch, tm);
+  CHECK_EQ(SPI.regs[0x0B], 0x30);
+  CHECK_EQ(SPI.regs[0x0C], 0x06);
+  CHECK_EQ(SPI.regs[0x0D], 0x80);
+  RTC.readAlarm(2, mode, back);
+  CHECK_EQ(mode, alarmModeHoursMatch);
+  CHECK_EQ(back.Hour, 6);
+  CHECK_EQ(back.Minute, 30);
+
+  RTC.setSQIMode(sqiModeAlarm2);
+  CHECK_EQ(SPI.regs[0x0E], 0x06);
+  CHECK(SPI.frames > frames);
+}
+
+/**
+ * \brief SRAM moves through 18h/19h in one burst per call
+ */
+static void testSRAM() {
+  uint8_t buf[100], back[100];
+  unsigned long frames;
+  uint8_t i;
+
+  SPI.reset();
+  for (i = 0; i < sizeof(buf); i++) buf[i] = i * 7 + 1;
+
+  frames = SPI.frames;
+  CHECK_EQ(SRAM.write(20, buf, sizeof(buf)), sizeof(buf));
+  CHECK_EQ(SPI.frames - frames, 2);  // address, then the data burst
+  CHECK(memcmp(SPI.sram + 20, buf, sizeof(buf)) == 0);
+  CHECK_EQ(SPI.sram[19], 0);
+  CHECK_EQ(SPI.sram[120], 0);
+
+  frames = SPI.frames;
+  CHECK_EQ(SRAM.read(20, back, sizeof(back)), sizeof(back));
+  CHECK_EQ(SPI.frames - frames, 2);
+  CHECK(memcmp(back, buf, sizeof(buf)) == 0);
+
+  // the Stream interface and the single byte calls
+  SRAM.write(3, 0xA5);
+  CHECK_EQ(SPI.sram[3], 0xA5);
+  CHECK_EQ(SRAM.read(3), 0xA5);
+  SRAM.seek(20);
+  CHECK_EQ(SRAM.read(), buf[0]);
+  CHECK_EQ(SRAM.read(), buf[1]);
+  CHECK_EQ(SRAM.tell(), 22);
+
+  // the bus stops at the end of the SRAM DS3232SRAM exposes
+  CHECK_EQ(SRAM.write(DS3232_SRAM_SIZE - 4, buf, 10), 4);
+  CHECK_EQ(SPI.sram[DS3232_SRAM_SIZE], 0);
+}
+
+/**
+ * \brief A missing DS3234 is found by the probe, though SPI has no acknowledge
+ */
+static void testPresence() {
+  static DS3234SPI absentBus(9);
+  uint8_t buf[4];
+
+  SPI.reset();
+  SPI.present = false;
+  RTC.setBus(absentBus);
+  CHECK(!RTC.available());
+  CHECK(!RTC.reprobe());
+  CHECK_EQ(SRAM.read(0, buf, sizeof(buf)), 0);
+  CHECK_EQ(absentBus.write(0x00, buf, sizeof(buf)), 0);
+
+  // Connected later
+  SPI.present = true;
+  CHECK(RTC.reprobe());
+  CHECK(RTC.available());
+  CHECK_EQ(SRAM.read(0, buf, sizeof(buf)), sizeof(buf));
+}
+
+int main() {
+  testPresence();
+  RTC.setBus(spiBus);
+  CHECK(RTC.reprobe());
+  testRegisters();
+  testSRAM();
+  return checkDone("test_spi");
+}
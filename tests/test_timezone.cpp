@@ -0,0 +1,185 @@
+/*
+ * test_timezone.cpp - DS3232Timezone against the C library's POSIX TZ rules
+ * Every transition from 1971 to 2105 is found in localtime_r() by a sweep
+ * and bisection, and checked at the second before and the second of it.
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "DS3232Timezone.h"
+#include "check.h"
+
+#define SWEEP_FROM  31536000LL     // 1971-01-01
+#define SWEEP_TO    4291747200LL   // 2106-01-01
+#define SWEEP_STEP  3607
+
+// Zones that glibc reads from the string alone; "EST5EDT" without rules
+// and DST all year are left out, glibc takes tzdata or its own view there
+static const char *zones[] = {
+  "UTC0",
+  "<+0330>-3:30",
+  "CET-1CEST,M3.5.0,M10.5.0/3",
+  "AEST-10AEDT,M10.1.0,M4.1.0/3",
+  "NZST-12NZDT,M9.5.0,M4.1.0/3",
+  "EST5EDT,M3.2.0/2:00:00,M11.1.0/2:00:00",
+  "IST-2IDT,M3.4.4/26,M10.5.0",
+  "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",
+  "XXX3YYY,J60/1,J300",
+  "AAA-5BBB-7,59,300/4",
+  "GMT0BST,M3.5.0/1,M10.5.0"
+};
+
+static long gmtoff(time_t t, bool &dst) {
+  struct tm lt;
+  localtime_r(&t, &lt);
+  dst = (lt.tm_isdst > 0);
+  return lt.tm_gmtoff;
+}
+
+/**
+ * \brief Compare one second, in the order given so the cache is exercised
+ */
+static void compare(DS3232Timezone &tz, time_t t) {
+  bool dst;
+  long off = gmtoff(t, dst);
+  CHECK_EQ(tz.toLocal(t) - t, off);
+  CHECK_EQ(tz.offset(t), off);
+  CHECK_EQ(tz.isDST(t), dst);
+}
+
+int main() {
+  unsigned z;
+  long transitions;
+
+  srand(3);
+  for (z = 0; z < sizeof(zones) / sizeof(zones[0]); z++) {
+    DS3232Timezone tz;
+    bool dst;
+    time_t t, lo, hi, mid;
+    long off, next;
+
+    setenv("TZ", zones[z], 1);
+    tzset();
+    CHECK(tz.begin(zones[z]));
+
+    // Sweep, bisecting each change of offset down to the second
+    transitions = 0;
+    off = gmtoff(SWEEP_FROM, dst);
+    for (t = SWEEP_FROM; t < SWEEP_TO; t += SWEEP_STEP) {
+      compare(tz, t);
+      next = gmtoff(t + SWEEP_STEP, dst);
+      if (next == off) continue;
+      for (lo = t, hi = t + SWEEP_STEP; hi - lo > 1; ) {
+        mid = lo + (hi - lo) / 2;
+        if (gmtoff(mid, dst) == off) lo = mid; else hi = mid;
+      }
+      compare(tz, hi - 1);
+      compare(tz, hi);
+      compare(tz, hi - 1);
+      off = next;
+      transitions++;
+    }
+    if (strchr(zones[z], ',')) {
+      CHECK_EQ(transitions, 2 * (2106 - 1971));
+    } else {
+      CHECK_EQ(transitions, 0);
+    }
+
+    // Random order, with local to UTC round trips
+    for (int k = 0; k < 100000; k++) {
+      t = SWEEP_FROM + (time_t)(((uint64_t)rand() * RAND_MAX + rand()) % (SWEEP_TO - SWEEP_FROM));
+      compare(tz, t);
+      time_t local = tz.toLocal(t);
+      time_t utc = tz.toUTC(local);
+      CHECK((utc == t) || (tz.toLocal(utc) == local));  // repeated hour
+    }
+  }
+
+  // A time skipped at the DST start moves forward
+  {
+    DS3232Timezone tz;
+    tz.begin("CET-1CEST,M3.5.0,M10.5.0/3");
+    CHECK_EQ(tz.toUTC(1711846800LL + 3600 + 1800), 1711846800LL + 1800);  // 2024-03-31 02:30 local
+    CHECK_EQ(tz.toLocal(1711846800LL + 1800), 1711846800LL + 7200 + 1800);  // is 03:30
+    CHECK_EQ(tz.toUTC(1711846800LL + 3600 - 1), 1711846800LL - 1);  // 01:59:59
+  }
+
+  // No DST: one offset for all of time_t
+  {
+    DS3232Timezone tz;
+    CHECK_EQ(tz.toLocal(1700000000), 1700000000);
+    CHECK(tz.begin("<+0330>-3:30"));
+    CHECK_EQ(tz.offset(0), 12600);
+    CHECK_EQ(tz.offset(0xFFFFFFFFLL), 12600);
+    CHECK_EQ(tz.toUTC(1700000000 + 12600), 1700000000);
+    CHECK(!tz.isDST(1700000000));
+    CHECK(tz.begin("CET-1CEST,M3.5.0,M10.5.0/3"));
+    CHECK(tz.isDST(1720000000));
+    CHECK(tz.begin("UTC0"));
+    CHECK(!tz.isDST(1720000000));
+    CHECK_EQ(tz.offset(1720000000), 0);
+  }
+
+  // save() and load()
+  {
+    DS3232Timezone a, b;
+    time_t t;
+    CHECK(a.begin(zones[2]));
+    a.toLocal(1700000000);
+    CHECK(a.save(10));
+    CHECK(b.load(10));
+    for (t = 1600000000; t < 1800000000; t += 3607) CHECK_EQ(a.toLocal(t), b.toLocal(t));
+    CHECK(a.begin(zones[1]));
+    CHECK(a.save(100));
+    CHECK(b.load(100));
+    CHECK_EQ(b.offset(1700000000), 12600);
+    CHECK(!a.save(DS3232_SRAM_SIZE - DS3232TZ_SAVE_SIZE + 1));
+    SRAM.write(20, SRAM.read(20) ^ 0xAA);
+    CHECK(!b.load(10));
+    CHECK_EQ(b.offset(1700000000), 12600);  // kept
+  }
+
+  // A block that sums right but holds rules begin() would refuse
+  {
+    // start rule Kind, Month, Week, Day, Day high byte, Time top byte
+    static const uint8_t at[] = { 10, 11, 12, 13, 14, 18 };
+    static const uint8_t bad[] = { 'X', 0, 6, 7, 0x80, 0x7F };
+    DS3232Timezone a, b;
+    uint8_t block[DS3232TZ_SAVE_SIZE];
+    unsigned i, k;
+    CHECK(b.begin("<+0330>-3:30"));
+    CHECK(a.begin(zones[2]));
+    for (i = 0; i < sizeof(at); i++) {
+      uint8_t sum = 0;
+      CHECK(a.save(10));
+      SRAM.read(10, block, sizeof(block));
+      block[at[i]] = bad[i];
+      for (k = 0; k < sizeof(block) - 1; k++) sum += block[k];
+      block[sizeof(block) - 1] = sum;
+      SRAM.write(10, block, sizeof(block));
+      CHECK(!b.load(10));
+      CHECK_EQ(b.offset(1700000000), 12600);  // kept
+    }
+    CHECK(a.save(10));
+    CHECK(b.load(10));
+  }
+
+  // Strings that don't parse leave the zone as it was
+  {
+    static const char *bad[] = {
+      "", "CE", "CET", "CET-25", "CET-1:60", "<AB>1", "<ABC1",
+      "CET-1CEST,M13.5.0,M10.5.0", "CET-1CEST,M3.6.0,M10.5.0", "CET-1CEST,M3.5.7,M10.5.0",
+      "CET-1CEST,M3.5.0", "CET-1CEST,J0,J300", "CET-1CEST,J1,366", "CET-1CEST;M3.5.0,M10.5.0",
+      "CET-1CEST,M3.5.0,M10.5.0x"
+    };
+    DS3232Timezone tz;
+    unsigned i;
+    CHECK(tz.begin("<+0330>-3:30"));
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+      CHECK(!tz.begin(bad[i]));
+      CHECK_EQ(tz.offset(1700000000), 12600);
+    }
+  }
+
+  return checkDone("test_timezone");
+}
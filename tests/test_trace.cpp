@@ -0,0 +1,122 @@
+/*
+ * test_trace.cpp - record a workload with DS3232Trace and replay it with DS3232Replay
+ * Also leaves the trace in build/sample.trace, in the TestRTC TRACE format,
+ * for `make check` to run through the replay tool.
+ */
+
+#include "DS3232Trace.h"
+#include "DS3232Log.h"
+#include "check.h"
+
+static DS3232Wire wireBus(Wire);
+static uint8_t ring[1024];
+
+/**
+ * \brief Some of everything: time, alarms, control, temperature and the SRAM log
+ */
+static time_t workload() {
+  tmElements_t tm;
+  alarmMode_t mode;
+  tpElements_t temp;
+  time_t t;
+
+  breakTime(1700000000UL, tm);
+  RTC.write(tm);
+  RTC.read(tm);
+  RTC.writeAlarm(1, alarmModeMinutesMatch, tm);
+  RTC.readAlarm(1, mode, tm);
+  RTC.setSQIMode(sqiModeAlarm1);
+  RTC.clearAlarmFlag(DS3232_A1F);
+  RTC.readTemperature(temp);
+  DS3232Log log(0, 64, 4);
+  log.begin(1700000000UL);
+  log.append(1700000003UL, 2);
+  log.append(1700000100UL, 5);
+  t = RTC.get();
+  return t + mode;
+}
+
+/**
+ * \brief Write the trace as the TRACE command prints it
+ */
+static void exportTrace(DS3232Trace &trace, const char *path) {
+  uint8_t chunk[16];
+  uint16_t offset, count, i;
+  FILE *out = fopen(path, "w");
+
+  if (!out) return;
+  fprintf(out, "%u bytes, %u records dropped\n", trace.used(), trace.dropped());
+  for (offset = 0; offset < trace.used(); offset += sizeof(chunk)) {
+    count = trace.copy(offset, chunk, sizeof(chunk));
+    for (i = 0; i < count; i++) fprintf(out, "%02X ", chunk[i]);
+    fprintf(out, "\n");
+  }
+  fclose(out);
+}
+
+static void testRecordReplay() {
+  static uint8_t exported[sizeof(ring)];
+  DS3232Trace trace(wireBus, ring, sizeof(ring));
+  tmElements_t tm;
+  unsigned long wireTx;
+  time_t recorded, replayed;
+  uint16_t n;
+
+  Wire.reset();
+  RTC.setBus(trace);
+  wireTx = Wire.transactions;
+  recorded = workload();
+  wireTx = Wire.transactions - wireTx;
+  CHECK_EQ(trace.dropped(), 0);
+  n = trace.copy(0, exported, sizeof(exported));
+  CHECK_EQ(n, trace.used());
+  CHECK_EQ(exported[0], DS3232TRACE_WRITE);  // RTC.write() starts with the time registers
+  CHECK_EQ(exported[1], 0x00);
+  CHECK_EQ(exported[2], 7);
+  exportTrace(trace, "build/sample.trace");
+
+  // the same calls against the replayed trace, no simulator
+  Wire.present = false;
+  DS3232Replay replay(exported, n);
+  RTC.setBus(replay);
+  replayed = workload();
+  CHECK_EQ(replayed, recorded);
+  CHECK_EQ(replay.mismatches(), 0);
+  CHECK(replay.done());
+  CHECK(replay.transactions() > 0);
+  CHECK(replay.transactions() <= wireTx);
+  CHECK_EQ(replay.busTime(), replay.transactions() * SIM_MICROS_STEP);  // one micros() step per call
+
+  // a different workload is caught
+  replay.rewind();
+  memset(&tm, 0, sizeof(tm));
+  RTC.writeAlarm(2, alarmModePerMinute, tm);
+  CHECK_EQ(replay.mismatches(), 1);
+  CHECK_EQ(replay.transactions(), 0);
+}
+
+static void testRing() {
+  uint8_t small[40], out[40];
+  tmElements_t tm;
+  int i;
+
+  Wire.reset();
+  DS3232Trace trace(wireBus, small, sizeof(small));
+  RTC.setBus(trace);
+  for (i = 0; i < 20; i++) RTC.read(tm);
+  // a time read record is 7 + 7 bytes, so two fit and the rest were dropped
+  CHECK_EQ(trace.used(), 28);
+  CHECK_EQ(trace.dropped(), 18);
+  CHECK_EQ(trace.copy(0, out, sizeof(out)), 28);
+  CHECK_EQ(out[2], 7);
+  CHECK_EQ(out[16], 7);
+  trace.clear();
+  CHECK_EQ(trace.used(), 0);
+}
+
+int main() {
+  testRecordReplay();
+  testRing();
+  RTC.setBus(wireBus);
+  return checkDone("test_trace");
+}